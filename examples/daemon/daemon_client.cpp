@@ -0,0 +1,65 @@
+#include "../../src/scip_client.hpp"
+
+#include <iostream>
+
+using namespace scip_wrapper;
+
+/*
+ * Sends a minimum weight vertex cover (MILP) and a maximum cut (QUBO) of the same graph to a running solve_daemon:
+ *   daemon_client <socket>
+ * The client is not linked against SCIP.
+ */
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <socket>" << std::endl;
+    return 1;
+  }
+
+  const std::vector<double> weights{1, 3, 3, 2, 2};
+  const std::vector<std::pair<fuint32_t, fuint32_t>> edges{{0, 1}, {0, 3}, {1, 3}, {1, 2}, {3, 4}, {2, 3}, {2, 4}};
+  DaemonConnection connection{argv[1]};
+
+  RemoteMILPSolver cover{connection, MINIMIZE};
+  cover.setTimeLimit(10.0);
+  std::vector<fuint32_t> nodes{};
+  for (double weight : weights) nodes.push_back(cover.createBinaryVar(weight));
+  for (const auto &edge : edges)
+  {
+    fuint32_t cstIndex = cover.createLinearConstraintGeq(1.0);
+    cover.addToCst(cstIndex, nodes[edge.first]);
+    cover.addToCst(cstIndex, nodes[edge.second]);
+  }
+  if (cover.solve())
+  {
+    std::cout << "Vertex cover of weight " << cover.getResult().objective << ":";
+    for (fuint32_t node : nodes)
+    {
+      if (cover.getBinaryValue(node)) std::cout << " " << node;
+    }
+    std::cout << " (" << cover.getResult().solvingTime << "s solving, " << cover.getResult().waitingTime << "s waiting)" << std::endl;
+  }
+  else std::cout << "No vertex cover: " << cover.getResult().message << std::endl;
+
+  RemoteQUBOSolver cut{connection, MAXIMIZE};
+  for (fuint32_t i = 0; i < weights.size(); i++) cut.createBinaryVar();
+  for (const auto &edge : edges)
+  { // x + y - 2xy is 1 iff the edge is cut
+    cut.addLinearTerm(edge.first);
+    cut.addLinearTerm(edge.second);
+    cut.addQuadraticTerm(edge.first, edge.second, -2.0);
+  }
+  if (cut.solve())
+  {
+    std::cout << "Cut of " << cut.getResult().objective << " edges:";
+    for (fuint32_t i = 0; i < weights.size(); i++)
+    {
+      if (cut.getBinaryValue(i)) std::cout << " " << i;
+    }
+    std::cout << std::endl;
+  }
+  else std::cout << "No cut: " << cut.getResult().message << std::endl;
+  return 0;
+}
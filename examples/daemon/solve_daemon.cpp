@@ -0,0 +1,45 @@
+#include "../../src/scip_daemon.hpp"
+
+#include <csignal>
+
+using namespace scip_wrapper;
+
+/*
+ * Serves models sent by clients (see daemon_client.cpp) until SIGINT or SIGTERM:
+ *   solve_daemon <socket> [workers] [queued requests] [default time limit] [settings file]
+ */
+
+namespace
+{
+  SolveDaemon *runningDaemon = nullptr;
+
+  void handleSignal(int)
+  {
+    if (runningDaemon != nullptr) runningDaemon->stop();
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <socket> [workers] [queued requests] [default time limit] [settings file]" << std::endl;
+    return 1;
+  }
+
+  DaemonOptions options{argv[1]};
+  if (argc > 2) options.nbWorkers = std::stoul(argv[2]);
+  if (argc > 3) options.maxQueued = std::stoul(argv[3]);
+  if (argc > 4) options.defaultTimeLimit = std::stod(argv[4]);
+  if (argc > 5) options.settingsPath = argv[5];
+
+  SolveDaemon solveDaemon{options};
+  runningDaemon = &solveDaemon;
+  std::signal(SIGINT, handleSignal);
+  std::signal(SIGTERM, handleSignal);
+  std::cout << "Serving on " << options.socketPath << " with " << options.nbWorkers << " workers..." << std::endl;
+  solveDaemon.run();
+  runningDaemon = nullptr;
+  solveDaemon.getStatistics().print(std::cout);
+  return 0;
+}
@@ -102,6 +102,15 @@ namespace example_types
     double y_length;
     std::string name;
   } rectangle_t;
+
+
+  struct PiecewiseLinearCost
+  {
+    PiecewiseLinearCost(std::string _name, std::vector<std::pair<double, double>> _breakpoints)
+      : name(_name), breakpoints(_breakpoints) {}
+    std::string name;
+    std::vector<std::pair<double, double>> breakpoints; // (amount, cost) sorted by amount
+  };
 }
 
 
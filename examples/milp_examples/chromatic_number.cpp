@@ -26,20 +26,60 @@ void milp_examples::chromatic_number(const std::vector<fuint32_t> &nodes,
     solver.addToCst(objCst, colorVar, -1.0);
   }
 
+  std::vector<fuint32_t> greaterVars{};
   for (const auto& edge : edges)
   {
     fuint32_t colorVarFrom = colorVars[edge.first];
     fuint32_t colorVarTo = colorVars[edge.second];
-    solver.createUnequalConstraint(colorVarFrom, colorVarTo, 2*nodes.size());
-    // 2*edges.size() is sufficiently large as the maximum chromatic number can be n
-    // ( = all nodes have different color )
+    greaterVars.push_back(solver.createUnequalConstraint(colorVarFrom, colorVarTo));
   }
 
+  // greedy coloring in the order of the LP colors gives an incumbent early on
+  solver.addHeuristic([&](SolutionView values)
+  {
+    std::vector<std::pair<double, fuint32_t>> order{};
+    for (auto node : nodes) order.push_back(std::make_pair(values[colorVars[node]], node));
+    std::sort(order.begin(), order.end());
+
+    std::multimap<fuint32_t, fuint32_t> adjacent{};
+    for (const auto& edge : edges)
+    {
+      adjacent.insert(std::make_pair(edge.first, edge.second));
+      adjacent.insert(std::make_pair(edge.second, edge.first));
+    }
+
+    std::map<fuint32_t, fuint32_t> colors{};
+    fuint32_t maxColor = 1;
+    for (const auto& entry : order)
+    {
+      std::set<fuint32_t> usedColors{};
+      auto range = adjacent.equal_range(entry.second);
+      for (auto it = range.first; it != range.second; ++it)
+      {
+        if (colors.count(it->second) != 0) usedColors.insert(colors[it->second]);
+      }
+      fuint32_t color = 1;
+      while (usedColors.count(color) != 0) color++;
+      colors[entry.second] = color;
+      maxColor = std::max(maxColor, color);
+    }
+
+    Assignment assignment(values.size(), 0.0);
+    assignment[targetNumber] = maxColor;
+    for (auto node : nodes) assignment[colorVars[node]] = colors[node];
+    for (fuint32_t i = 0; i < edges.size(); i++)
+    {
+      assignment[greaterVars[i]] = colors[edges[i].first] > colors[edges[i].second] ? 1.0 : 0.0;
+    }
+    return std::vector<Assignment>{assignment};
+  }, SCIP_HEURTIMING_AFTERLPNODE, 1, "greedy_coloring");
+
   if (!solver.solve())
   {
     std::cerr << "Something failed..." << std::endl;
     return;
   }
+  solver.printHeuristicStatistics(std::cout);
 
   for (auto node : nodes)
   {
@@ -55,6 +95,60 @@ void milp_examples::chromatic_number(const std::vector<fuint32_t> &nodes,
   std::cout << "Chromatic number of the graph is " << solver.getVariableValue(targetNumber) << std::endl;
 }
 
+void milp_examples::chromatic_number_assignment(const std::vector<fuint32_t> &nodes,
+                                 const std::vector<EdgePair> &edges)
+{ // binary assignment of colors to nodes, the colors are interchangeable which is handled by an orbitope
+  MILPSolver solver{"chromaticNumberAssignmentSolver", SolverSense::MINIMIZE};
+  const fuint32_t nbColors = nodes.size();
+
+  std::vector<fuint32_t> colorUsedVars{};
+  for (fuint32_t color = 0; color < nbColors; color++) colorUsedVars.push_back(solver.createBinaryVar(1.0));
+
+  // rows are nodes, columns are colors
+  std::map<fuint32_t, fuint32_t> nodeRows{};
+  std::vector<std::vector<fuint32_t>> assignmentVars{};
+  for (auto node : nodes)
+  {
+    nodeRows.insert(std::make_pair(node, assignmentVars.size()));
+    assignmentVars.push_back(std::vector<fuint32_t>{});
+    fuint32_t oneColorCst = solver.createLinearConstraintEq(1.0);
+    for (fuint32_t color = 0; color < nbColors; color++)
+    {
+      assignmentVars.back().push_back(solver.createBinaryVar(0.0));
+      solver.addToCst(oneColorCst, assignmentVars.back().back());
+    }
+  }
+
+  for (const auto& edge : edges)
+  {
+    for (fuint32_t color = 0; color < nbColors; color++)
+    { // adjacent nodes cannot both have the color, and only if it is used
+      fuint32_t cst = solver.createLinearConstraintLeq(0.0);
+      solver.addToCst(cst, assignmentVars[nodeRows[edge.first]][color]);
+      solver.addToCst(cst, assignmentVars[nodeRows[edge.second]][color]);
+      solver.addToCst(cst, colorUsedVars[color], -1.0);
+    }
+  }
+  solver.createOrbitope(assignmentVars, PARTITIONING_ORBITOPE);
+
+  if (!solver.solve())
+  {
+    std::cerr << "Something failed..." << std::endl;
+    return;
+  }
+
+  fuint32_t usedColors = 0;
+  for (auto colorUsedVar : colorUsedVars) usedColors += solver.getBinaryValue(colorUsedVar) ? 1 : 0;
+  for (auto node : nodes)
+  {
+    for (fuint32_t color = 0; color < nbColors; color++)
+    {
+      if (solver.getBinaryValue(assignmentVars[nodeRows[node]][color])) std::cout << "Node " << node << " has color " << color << std::endl;
+    }
+  }
+  std::cout << "Chromatic number of the graph is " << usedColors << " (" << solver.getNbNodes() << " nodes)" << std::endl;
+}
+
 
 int main()
 {
@@ -96,4 +190,5 @@ int main()
   //   EdgePair(5,1)
   // };
   milp_examples::chromatic_number(nodes, edges);
+  milp_examples::chromatic_number_assignment(nodes, edges);
 }
\ No newline at end of file
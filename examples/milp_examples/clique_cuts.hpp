@@ -0,0 +1,56 @@
+#ifndef CLIQUE_CUTS_HPP
+#define CLIQUE_CUTS_HPP
+
+#include "milp_examples.hpp"
+
+namespace milp_examples
+{
+  // Greedy separation of clique inequalities: at most one node of a clique of the conflict graph can be chosen.
+  // Starting at each node with positive LP value, a clique is grown using the nodes with the largest LP values.
+  inline std::vector<scip_wrapper::LinearRow> separateCliqueCuts(const std::map<fuint32_t, fuint32_t> &nodeVars,
+                                                                 const std::set<EdgePair> &conflicts,
+                                                                 scip_wrapper::SolutionView values)
+  {
+    const double tolerance = 1e-6;
+    auto inConflict = [&](fuint32_t a, fuint32_t b)
+    {
+      return conflicts.count(EdgePair(std::min(a, b), std::max(a, b))) != 0;
+    };
+
+    std::vector<std::pair<double, fuint32_t>> candidates{};
+    for (const auto &nodeVar : nodeVars)
+    {
+      double value = values[nodeVar.second];
+      if (value > tolerance) candidates.push_back(std::make_pair(value, nodeVar.first));
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<std::pair<double, fuint32_t>>());
+
+    std::vector<scip_wrapper::LinearRow> cuts{};
+    std::set<std::vector<fuint32_t>> found{};
+    for (const auto &start : candidates)
+    {
+      std::vector<fuint32_t> clique{start.second};
+      double cliqueValue = start.first;
+      for (const auto &candidate : candidates)
+      {
+        if (candidate.second == start.second) continue;
+        bool conflictsAll = std::all_of(clique.begin(), clique.end(),
+                                        [&](fuint32_t node){ return inConflict(node, candidate.second); });
+        if (!conflictsAll) continue;
+        clique.push_back(candidate.second);
+        cliqueValue += candidate.first;
+      }
+      if (cliqueValue <= 1.0 + tolerance) continue;
+
+      std::sort(clique.begin(), clique.end());
+      if (!found.insert(clique).second) continue;
+
+      scip_wrapper::LinearRow cut{-scip_wrapper::INF_BOUND, 1.0};
+      for (auto node : clique) cut.addVariable(nodeVars.at(node));
+      cuts.push_back(cut);
+    }
+    return cuts;
+  }
+}
+
+#endif
@@ -51,6 +51,14 @@ void milp_examples::solve_dependency_knapsack(const DependencyKnapsackItems &ite
     }
   }
 
+  // the LP relaxation bounds the value, the dual of the capacity row is the value of additional capacity
+  LPSolution relaxation{};
+  if (solver.solveRelaxation(relaxation))
+  {
+    std::cout << "LP bound: " << relaxation.objective << ", value of capacity: "
+              << relaxation.duals[capacityConstraint] << " per unit" << std::endl;
+  }
+
   solver.solve();
 
   // Check solution
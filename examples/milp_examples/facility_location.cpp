@@ -0,0 +1,87 @@
+#include "milp_examples.hpp"
+
+using namespace scip_wrapper;
+using namespace milp_examples;
+
+/*
+ * Uncapacitated facility location: open facilities (opening costs) and serve the demand
+ * of every customer from open facilities (costs per unit of demand). Once the facilities
+ * are chosen, the customers are independent LPs. With Benders decomposition the master
+ * only decides the facilities and every customer is a subproblem of its own, otherwise
+ * one monolithic model is solved.
+ */
+
+void milp_examples::facility_location(const std::vector<double> &openingCosts, const std::vector<double> &demands,
+                                      const std::vector<std::vector<double>> &costs, bool benders)
+{
+  std::vector<std::unique_ptr<MILPSolver>> subproblems{}; // declared first as they must outlive the master
+  MILPSolver master{"FacilityLocationSolver", SolverSense::MINIMIZE};
+
+  std::vector<fuint32_t> openVars{};
+  fuint32_t anyOpenCst = master.createLinearConstraintGeq(1.0);
+  for (auto openingCost : openingCosts)
+  {
+    openVars.push_back(master.createBinaryVar(openingCost));
+    master.addToCst(anyOpenCst, openVars.back());
+  }
+
+  for (fuint32_t customer = 0; customer < demands.size(); customer++)
+  {
+    MILPSolver *solver = &master;
+    std::vector<fuint32_t> facilityVars = openVars;
+    if (benders)
+    { // the subproblem gets continuous copies of the master's binaries
+      subproblems.emplace_back(new MILPSolver{"Customer" + std::to_string(customer), SolverSense::MINIMIZE});
+      solver = subproblems.back().get();
+      std::vector<std::pair<fuint32_t, fuint32_t>> linkingVars{};
+      for (fuint32_t facility = 0; facility < openVars.size(); facility++)
+      {
+        facilityVars[facility] = solver->createVar(CONTINUOUS, 0.0, 1.0, 0.0);
+        linkingVars.push_back(std::make_pair(openVars[facility], facilityVars[facility]));
+      }
+      master.addBendersSubproblem(*solver, linkingVars);
+    }
+
+    fuint32_t servedCst = solver->createLinearConstraintEq(1.0);
+    for (fuint32_t facility = 0; facility < openVars.size(); facility++)
+    { // share of the demand served by the facility, only from open facilities
+      fuint32_t serveVar = solver->createVar(CONTINUOUS, 0.0, 1.0, demands[customer] * costs[facility][customer]);
+      solver->addToCst(servedCst, serveVar);
+      fuint32_t openCst = solver->createLinearConstraintLeq(0.0);
+      solver->addToCst(openCst, serveVar);
+      solver->addToCst(openCst, facilityVars[facility], -1.0);
+    }
+  }
+  if (benders) master.setBendersThreads(4);
+
+  if (!master.solve())
+  {
+    std::cout << "No facilities can be opened..." << std::endl;
+    return;
+  }
+
+  std::cout << "Open facilities:";
+  for (fuint32_t facility = 0; facility < openVars.size(); facility++)
+  {
+    if (master.getBinaryValue(openVars[facility])) std::cout << " " << facility;
+  }
+  std::cout << std::endl << "Total cost: " << SCIPgetPrimalbound(master.getModel())
+            << " (" << master.getSolvingTime() << "s)" << std::endl;
+  master.printBendersStatistics(std::cout);
+}
+
+int main()
+{
+  std::vector<double> openingCosts{ 120, 90, 150, 80, 110 };
+  std::vector<double> demands{ 10, 25, 15, 30, 20, 5, 40, 35 };
+  std::vector<std::vector<double>> costs
+  { // per unit of demand, facilities x customers
+    { 1, 4, 6, 3, 8, 2, 5, 7 },
+    { 5, 2, 3, 6, 4, 7, 2, 3 },
+    { 3, 6, 1, 2, 5, 4, 6, 2 },
+    { 7, 3, 5, 8, 1, 6, 3, 4 },
+    { 4, 5, 4, 1, 3, 3, 1, 6 }
+  };
+  milp_examples::facility_location(openingCosts, demands, costs, false);
+  milp_examples::facility_location(openingCosts, demands, costs, true);
+}
@@ -1,4 +1,6 @@
 #include "milp_examples.hpp"
+#include "clique_cuts.hpp"
+#include "../../src/scip_builder.hpp"
 
 using namespace scip_wrapper;
 using namespace milp_examples;
@@ -6,6 +8,7 @@ using namespace milp_examples;
 /* keksklauer4 16.03.2021
  *
  * Calculate a maximal independent set for a given graph using a MILP.
+ * The edge rows are strengthened by clique cuts generated by a separator.
  */
 
 void milp_examples::solve_independent_set(const std::vector<EdgePair> &edges,
@@ -22,19 +25,34 @@ void milp_examples::solve_independent_set(const std::vector<EdgePair> &edges,
     nodeIndices.insert(std::make_pair(*it, varIndex));
   }
 
-  // create constraints
-  for (auto it = edges.begin(); it != edges.end(); ++it)
+  // create constraints, the edge rows are built by several threads (one row per edge)
+  ModelBuilder builder{solver};
+  builder.forEach(4, edges.size(), 0, 1, [&](BuildContext &context, fuint32_t edge)
   {
-    fuint32_t nodeIndexA = nodeIndices[it->first];
-    fuint32_t nodeIndexB = nodeIndices[it->second];
+    fuint32_t nodeIndexA = nodeIndices.at(edges[edge].first);
+    fuint32_t nodeIndexB = nodeIndices.at(edges[edge].second);
 
     // for each edge at most one adjacent variable is allowed to be in the independent set
-    fuint32_t cstIndex = solver.createLinearConstraintLeq(1.0);
-    solver.addToCst(cstIndex, nodeIndexA);
-    solver.addToCst(cstIndex, nodeIndexB);
+    fuint32_t cstIndex = context.createLinearConstraintLeq(1.0);
+    context.addToCst(cstIndex, nodeIndexA);
+    context.addToCst(cstIndex, nodeIndexB);
+  });
+  solver.merge(builder);
+
+  std::set<EdgePair> conflicts{};
+  for (auto it = edges.begin(); it != edges.end(); ++it)
+  {
+    conflicts.insert(EdgePair(std::min(it->first, it->second), std::max(it->first, it->second)));
   }
 
+  // at most one node of each clique is in the independent set
+  solver.addSeparator([&](SolutionView values)
+  {
+    return separateCliqueCuts(nodeIndices, conflicts, values);
+  }, 1000, 1, "clique");
+
   solver.solve();
+  solver.printSeparatorStatistics(std::cout);
 
   // Check solution
   std::cout << (solver.getSolution() != nullptr ? "Sucess!" : "An error occurred...") << std::endl;
@@ -0,0 +1,155 @@
+#include "milp_examples.hpp"
+
+using namespace scip_wrapper;
+using namespace milp_examples;
+
+/*
+ * Compares big-M rows with indicator constraints on the rectangle packing
+ * and the chromatic number model (same formulations as in the examples).
+ */
+
+namespace
+{
+  struct BenchmarkResult
+  {
+    SCIP_Longint nodes;
+    double time;
+    double objective;
+  };
+
+  void addImplication(MILPSolver &solver, bool useIndicator, double bigM,
+                      fuint32_t binVar, bool activeValue, const LinearRow &row)
+  { // binVar == activeValue => row <= rhs
+    if (useIndicator)
+    {
+      solver.createIndicatorConstraint(binVar, activeValue, row);
+      return;
+    }
+    fuint32_t cst = solver.createLinearConstraintLeq(row.rhs + (activeValue ? bigM : 0.0));
+    for (fuint32_t i = 0; i < row.vars.size(); i++)
+    {
+      solver.addToCst(cst, row.vars[i], row.coefficients[i]);
+    }
+    solver.addToCst(cst, binVar, activeValue ? bigM : -bigM);
+  }
+
+  BenchmarkResult solveAndMeasure(MILPSolver &solver)
+  {
+    solver.solve();
+    return BenchmarkResult{solver.getNbNodes(), solver.getSolvingTime(), SCIPgetPrimalbound(solver.getModel())};
+  }
+
+  BenchmarkResult rectanglePacking(const std::vector<rectangle_t> &rects, double xLength, double yLength, bool useIndicator)
+  {
+    const double bigM = 1000000.0;
+    MILPSolver solver{"RectPackingBenchmark", SolverSense::MINIMIZE};
+
+    std::vector<std::pair<fuint32_t, fuint32_t>> coordVars{};
+    for (const auto &rect : rects)
+    {
+      fuint32_t x = solver.createVarLowerBounded(CONTINUOUS, 0.0, 0.0);
+      fuint32_t y = solver.createVarLowerBounded(CONTINUOUS, 0.0, 0.0);
+      fuint32_t excludedVar = solver.createBinaryVar(rect.x_length * rect.y_length);
+      coordVars.push_back(std::make_pair(x, y));
+
+      LinearRow xInBoard{-INF_BOUND, xLength - rect.x_length};
+      xInBoard.addVariable(x);
+      addImplication(solver, useIndicator, bigM, excludedVar, false, xInBoard);
+      LinearRow yInBoard{-INF_BOUND, yLength - rect.y_length};
+      yInBoard.addVariable(y);
+      addImplication(solver, useIndicator, bigM, excludedVar, false, yInBoard);
+    }
+
+    auto separate = [&](double length, fuint32_t a, fuint32_t b)
+    { // cstVar = 1 => a + length <= b
+      fuint32_t cstVar = solver.createBinaryVar(0.0);
+      LinearRow row{-INF_BOUND, -length};
+      row.addVariable(a);
+      row.addVariable(b, -1.0);
+      addImplication(solver, useIndicator, bigM, cstVar, true, row);
+      return cstVar;
+    };
+
+    for (fuint32_t i = 0; i < rects.size(); i++)
+    {
+      for (fuint32_t j = i + 1; j < rects.size(); j++)
+      {
+        fuint32_t nonOverlappingCst = solver.createLinearConstraintGeq(1.0);
+        solver.addToCst(nonOverlappingCst, separate(rects[i].x_length, coordVars[i].first, coordVars[j].first));
+        solver.addToCst(nonOverlappingCst, separate(rects[j].x_length, coordVars[j].first, coordVars[i].first));
+        solver.addToCst(nonOverlappingCst, separate(rects[i].y_length, coordVars[i].second, coordVars[j].second));
+        solver.addToCst(nonOverlappingCst, separate(rects[j].y_length, coordVars[j].second, coordVars[i].second));
+      }
+    }
+    return solveAndMeasure(solver);
+  }
+
+  BenchmarkResult chromaticNumber(const std::vector<fuint32_t> &nodes, const std::vector<EdgePair> &edges, bool useIndicator)
+  {
+    const double bigM = 2.0 * nodes.size();
+    MILPSolver solver{"ChromaticNumberBenchmark", SolverSense::MINIMIZE};
+
+    fuint32_t targetNumber = solver.createVarLowerBounded(CONTINUOUS, 0.0, 1.0);
+    std::map<fuint32_t, fuint32_t> colorVars{};
+    for (auto node : nodes)
+    {
+      fuint32_t colorVar = solver.createIntVar(1.0, nodes.size(), 0.0);
+      colorVars.insert(std::make_pair(node, colorVar));
+      fuint32_t objCst = solver.createLinearConstraintGeq(0.0);
+      solver.addToCst(objCst, targetNumber);
+      solver.addToCst(objCst, colorVar, -1.0);
+    }
+
+    for (const auto &edge : edges)
+    { // y = 1 => color(first) < color(second), y = 0 => color(second) < color(first)
+      fuint32_t yVar = solver.createBinaryVar(0.0);
+      LinearRow smaller{-INF_BOUND, -1.0};
+      smaller.addVariable(colorVars[edge.first]);
+      smaller.addVariable(colorVars[edge.second], -1.0);
+      addImplication(solver, useIndicator, bigM, yVar, true, smaller);
+
+      LinearRow greater{-INF_BOUND, -1.0};
+      greater.addVariable(colorVars[edge.second]);
+      greater.addVariable(colorVars[edge.first], -1.0);
+      addImplication(solver, useIndicator, bigM, yVar, false, greater);
+    }
+    return solveAndMeasure(solver);
+  }
+
+  void printResult(const std::string &name, const BenchmarkResult &bigM, const BenchmarkResult &indicator)
+  {
+    std::cout << name << std::endl
+              << "  big-M:     " << bigM.nodes << " nodes, " << bigM.time << "s, objective " << bigM.objective << std::endl
+              << "  indicator: " << indicator.nodes << " nodes, " << indicator.time << "s, objective " << indicator.objective << std::endl;
+  }
+}
+
+int main()
+{
+  std::vector<rectangle_t> rects
+  {
+    Rectangle{300, 400, "Rect1"},
+    Rectangle{200, 200, "Rect2"},
+    Rectangle{100, 300, "Rect3"},
+    Rectangle{500, 200, "Rect4"},
+    Rectangle{300, 300, "Rect5"},
+    Rectangle{400, 400, "Rect6"},
+    Rectangle{600, 400, "Rect7"},
+    Rectangle{400, 300, "Rect8"},
+    Rectangle{400, 200, "Rect9"},
+    Rectangle{100, 300, "Rect10"}
+  };
+  printResult("Rectangle packing", rectanglePacking(rects, 1000.0, 1000.0, false),
+                                   rectanglePacking(rects, 1000.0, 1000.0, true));
+
+  // Example taken from Wikipedia: https://en.wikipedia.org/wiki/Graph_coloring
+  std::vector<fuint32_t> nodes{0,1,2,3,4,5,6,7,8,9};
+  std::vector<EdgePair> edges
+  {
+    EdgePair(0,1), EdgePair(1,2), EdgePair(2,3), EdgePair(3,4), EdgePair(4,0),
+    EdgePair(0,5), EdgePair(1,6), EdgePair(2,7), EdgePair(3,8), EdgePair(4,9),
+    EdgePair(5,7), EdgePair(7,9), EdgePair(9,6), EdgePair(6,8), EdgePair(8,5)
+  };
+  printResult("Chromatic number", chromaticNumber(nodes, edges, false), chromaticNumber(nodes, edges, true));
+  return 0;
+}
@@ -3,11 +3,83 @@
 using namespace scip_wrapper;
 using namespace milp_examples;
 
+namespace
+{
+  struct EdgeVars
+  {
+    fuint32_t fromNode;
+    fuint32_t toNode;
+    fuint32_t fromTo;
+    fuint32_t toFrom;
+  };
+
+  std::vector<LinearRow> findDisconnectedCycles(const std::vector<EdgeVars> &edgeVars,
+                                                std::map<fuint32_t, fuint32_t> &inflowVars,
+                                                std::map<fuint32_t, fuint32_t> &outflowVars,
+                                                SolutionView values)
+  { // a component of used edges containing neither start nor end node is a cycle not connected to the path.
+    // The path can only use an edge of the component if it leaves the component or starts/ends in it.
+    std::multimap<fuint32_t, fuint32_t> adjacent{};
+    for (const auto &edge : edgeVars)
+    {
+      if (values[edge.fromTo] + values[edge.toFrom] < 0.5) continue;
+      adjacent.insert(std::make_pair(edge.fromNode, edge.toNode));
+      adjacent.insert(std::make_pair(edge.toNode, edge.fromNode));
+    }
+
+    std::vector<LinearRow> rows{};
+    std::set<fuint32_t> visited{};
+    for (const auto &entry : adjacent)
+    {
+      if (visited.count(entry.first) != 0) continue;
+      std::set<fuint32_t> component{entry.first};
+      std::vector<fuint32_t> stack{entry.first};
+      double endpoints = 0.0;
+      while (!stack.empty())
+      {
+        fuint32_t node = stack.back();
+        stack.pop_back();
+        endpoints += values[inflowVars[node]] + values[outflowVars[node]];
+        auto range = adjacent.equal_range(node);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+          if (component.insert(it->second).second) stack.push_back(it->second);
+        }
+      }
+      visited.insert(component.begin(), component.end());
+      if (endpoints > 0.5) continue;
 
+      LinearRow row{-INF_BOUND, 0.0};
+      bool insideEdgeAdded = false;
+      for (const auto &edge : edgeVars)
+      {
+        bool fromInside = component.count(edge.fromNode) != 0;
+        bool toInside = component.count(edge.toNode) != 0;
+        if (fromInside != toInside)
+        {
+          row.addVariable(edge.fromTo, -1.0);
+          row.addVariable(edge.toFrom, -1.0);
+        }
+        else if (fromInside && !insideEdgeAdded && values[edge.fromTo] + values[edge.toFrom] > 0.5)
+        {
+          row.addVariable(values[edge.fromTo] > 0.5 ? edge.fromTo : edge.toFrom);
+          insideEdgeAdded = true;
+        }
+      }
+      for (auto node : component)
+      {
+        row.addVariable(inflowVars[node], -1.0);
+        row.addVariable(outflowVars[node], -1.0);
+      }
+      rows.push_back(row);
+    }
+    return rows;
+  }
+}
 
 void milp_examples::longest_path_problem_catan(const std::vector<EdgePair> &edges,
                                 const std::vector<fuint32_t> &nodes,
-                                LongestPathResult& res)
+                                LongestPathResult& res, bool lazyConnectivity)
 {
   MILPSolver solver{"longestPathSolver", SolverSense::MAXIMIZE};
 
@@ -35,7 +107,7 @@ void milp_examples::longest_path_problem_catan(const std::vector<EdgePair> &edge
   std::map<fuint32_t, fuint32_t> orderVars{};
   for (auto node : nodes)
   {
-    orderVars.insert(std::make_pair(node, solver.createIntVar(1.0, q, 0.0)));
+    if (!lazyConnectivity) orderVars.insert(std::make_pair(node, solver.createIntVar(1.0, q, 0.0)));
 
     fuint32_t flowConstraint = solver.createLinearConstraintEq(0.0);
     flowConstraints.insert(std::make_pair(node, flowConstraint));
@@ -45,6 +117,7 @@ void milp_examples::longest_path_problem_catan(const std::vector<EdgePair> &edge
   }
 
   std::multimap<fuint32_t, std::pair<fuint32_t, fuint32_t>> edgeVars{};
+  std::vector<EdgeVars> edgeVarList{};
   for (const auto &edge : edges)
   {
     fuint32_t edgeFromTo = solver.createBinaryVar(1.0);
@@ -63,6 +136,14 @@ void milp_examples::longest_path_problem_catan(const std::vector<EdgePair> &edge
     solver.addToCst(toNodeCst,   edgeFromTo,  1.0); // inflow
     solver.addToCst(toNodeCst,   edgeToFrom, -1.0); // flows out of toNode
 
+    edgeVars.insert(std::make_pair(edge.first, std::make_pair(edge.second, edgeFromTo)));
+    edgeVars.insert(std::make_pair(edge.second, std::make_pair(edge.first,  edgeToFrom)));
+    edgeVarList.push_back(EdgeVars{edge.first, edge.second, edgeFromTo, edgeToFrom});
+    // deciding edges is much more effective than branching on the order variables
+    solver.setBranching(edgeFromTo, 10);
+    solver.setBranching(edgeToFrom, 10);
+    if (lazyConnectivity) continue;
+
     // create order constraint
     fuint32_t fromNodeOrderVar = orderVars[edge.first];
     fuint32_t toNodeOrderVar = orderVars[edge.second];
@@ -82,11 +163,14 @@ void milp_examples::longest_path_problem_catan(const std::vector<EdgePair> &edge
     solver.addToCst(toNodeOrderCst, edgeToFrom, q);
     solver.addToCst(toNodeOrderCst, inflowVars[edge.first], -2*q);
     solver.addToCst(toNodeOrderCst, outflowVars[edge.first], -2*q);
+  }
 
-    // insert variables
-    // std::cout << ">>> " << edge.first << " <-> " << edge.second  << "       " << edgeFromTo << "  " << edgeToFrom << std::endl;
-    edgeVars.insert(std::make_pair(edge.first, std::make_pair(edge.second, edgeFromTo)));
-    edgeVars.insert(std::make_pair(edge.second, std::make_pair(edge.first,  edgeToFrom)));
+  if (lazyConnectivity)
+  {
+    solver.addLazyConstraintCallback([&](SolutionView values)
+    {
+      return findDisconnectedCycles(edgeVarList, inflowVars, outflowVars, values);
+    });
   }
 
   if(!solver.solve())
@@ -107,10 +191,13 @@ void milp_examples::longest_path_problem_catan(const std::vector<EdgePair> &edge
     }
   }
 
-  std::cout << "Outputting order variables" << std::endl;
-  for (auto node : nodes)
+  if (!lazyConnectivity)
   {
-    std::cout << "Node " << node << " has order value " << orderVars[node] << "." << std::endl;
+    std::cout << "Outputting order variables" << std::endl;
+    for (auto node : nodes)
+    {
+      std::cout << "Node " << node << " has order value " << solver.getVariableValue(orderVars[node]) << "." << std::endl;
+    }
   }
 
   for (auto node : nodes)
@@ -133,6 +220,8 @@ void milp_examples::longest_path_problem_catan(const std::vector<EdgePair> &edge
 
   std::cout << std::endl
             << "Total length is " << length << std::endl;
+  std::cout << (lazyConnectivity ? "Lazy connectivity rows: " : "Order formulation: ") << solver.getNbNodes() << " nodes, "
+            << solver.getSolvingTime() << "s, " << solver.getNbLazyRowsAdded() << " lazy rows" << std::endl;
 }
 
 namespace
@@ -355,10 +444,12 @@ namespace
       EdgePair(18,19),
       EdgePair(20,21)
     };
-    LongestPathResult res{};
-
-    milp_examples::longest_path_problem_catan(edges, nodes, res);
-    printPath(res);
+    for (bool lazyConnectivity : {true, false})
+    {
+      LongestPathResult res{};
+      milp_examples::longest_path_problem_catan(edges, nodes, res, lazyConnectivity);
+      printPath(res);
+    }
   }
 }
 
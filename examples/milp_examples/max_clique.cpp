@@ -1,4 +1,5 @@
 #include "milp_examples.hpp"
+#include "clique_cuts.hpp"
 
 using namespace scip_wrapper;
 using namespace milp_examples;
@@ -13,36 +14,56 @@ void milp_examples::max_clique(const std::vector<fuint32_t>& nodes,
   fuint32_t amountNodesCst = solver.createLinearConstraintEq();
   solver.addToCst(amountNodesCst, amountNodesInCliqueVar);
 
+  // if a node is in the clique, all other clique nodes must be adjacent:
+  // cliqueVar = 1 => amountNodesInClique - sum of adjacent cliqueVars <= 1
   std::map<fuint32_t, fuint32_t> cliqueVars{};
-  std::map<fuint32_t, fuint32_t> connectionCsts{};
+  std::map<fuint32_t, LinearRow> connectionRows{};
   for (auto node : nodes)
   {
     fuint32_t cliqueVar = solver.createBinaryVar(1.0);
     cliqueVars.insert(std::make_pair(node, cliqueVar));
     solver.addToCst(amountNodesCst, cliqueVar, -1.0);
 
-    fuint32_t connectionCst = solver.createLinearConstraintLeq(edges.size() + 1);
-    solver.addToCst(connectionCst, amountNodesInCliqueVar);
-    solver.addToCst(connectionCst, cliqueVar, edges.size());
-    connectionCsts.insert(std::make_pair(node, connectionCst));
+    LinearRow connectionRow{-INF_BOUND, 1.0};
+    connectionRow.addVariable(amountNodesInCliqueVar);
+    connectionRows.insert(std::make_pair(node, connectionRow));
   }
 
   for (const auto& edge : edges)
   {
-    fuint32_t nodeAClique = cliqueVars[edge.first];
-    fuint32_t nodeBClique = cliqueVars[edge.second];
-    fuint32_t connectionCstA = connectionCsts[edge.first];
-    fuint32_t connectionCstB = connectionCsts[edge.second];
+    connectionRows.at(edge.first).addVariable(cliqueVars[edge.second], -1.0);
+    connectionRows.at(edge.second).addVariable(cliqueVars[edge.first], -1.0);
+  }
 
-    solver.addToCst(connectionCstA, nodeBClique, -1.0);
-    solver.addToCst(connectionCstB, nodeAClique, -1.0);
+  for (const auto& connectionRow : connectionRows)
+  {
+    solver.createIndicatorConstraint(cliqueVars[connectionRow.first], true, connectionRow.second);
   }
 
+  // a clique contains at most one node of an independent set, thus clique cuts of the complement graph are valid
+  std::set<EdgePair> nonAdjacent{};
+  for (auto a : nodes)
+  {
+    for (auto b : nodes)
+    {
+      if (a < b) nonAdjacent.insert(EdgePair(a, b));
+    }
+  }
+  for (const auto& edge : edges)
+  {
+    nonAdjacent.erase(EdgePair(std::min(edge.first, edge.second), std::max(edge.first, edge.second)));
+  }
+  solver.addSeparator([&](SolutionView values)
+  {
+    return separateCliqueCuts(cliqueVars, nonAdjacent, values);
+  }, 1000, 1, "independent_set");
+
   if (!solver.solve())
   {
     std::cerr << "Error occurred." << std::endl;
     return;
   }
+  solver.printSeparatorStatistics(std::cout);
 
   fuint32_t cliqueNb = 0;
   for (auto &cliqueVar : cliqueVars)
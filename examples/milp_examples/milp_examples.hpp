@@ -8,7 +8,9 @@ namespace milp_examples
 {
   using namespace example_types;
   void solve_minimum_vertex_cover(std::vector<EdgePair> &edges,
-                                  std::vector<double> weights);
+                                  std::vector<double> weights,
+                                  scip_wrapper::PortfolioStatistics *portfolio = nullptr,
+                                  scip_wrapper::SolutionCache *cache = nullptr);
   void solve_independent_set(const std::vector<EdgePair> &edges,
                              const std::vector<scip_wrapper::fuint32_t> nodes);
 
@@ -32,16 +34,19 @@ namespace milp_examples
 
   void longest_path_problem_catan(const std::vector<EdgePair> &edges,
                                   const std::vector<fuint32_t> &nodes,
-                                  LongestPathResult& res);
+                                  LongestPathResult& res, bool lazyConnectivity = true);
 
 
   void travelling_salesman_problem(const std::vector<fuint32_t> &nodes,
                                    const std::vector<EdgeWithCost> &edges,
-                                   fuint32_t startNode);
+                                   fuint32_t startNode, bool lazySubtourElimination = true);
 
   void chromatic_number(const std::vector<fuint32_t> &nodes,
                         const std::vector<EdgePair> &edges);
 
+  void chromatic_number_assignment(const std::vector<fuint32_t> &nodes,
+                                   const std::vector<EdgePair> &edges);
+
   void three_partition(const std::vector<fuint32_t> &numbers);
 
   void max_clique(const std::vector<fuint32_t> &nodes,
@@ -51,7 +56,13 @@ namespace milp_examples
                         const std::vector<weight_edge_t> &edges);
 
 
-  void rectangle_packing(std::vector<rectangle_t> &rects, double xLength, double yLength);
+  void rectangle_packing(std::vector<rectangle_t> &rects, double xLength, double yLength, fuint32_t threads = 1);
+
+  void facility_location(const std::vector<double> &openingCosts, const std::vector<double> &demands,
+                         const std::vector<std::vector<double>> &costs, bool benders = true);
+
+  void piecewise_linear_cost(const std::vector<PiecewiseLinearCost> &suppliers,
+                             double demand, fuint32_t maxSuppliers);
 
 }
 
@@ -16,6 +16,7 @@ void milp_examples::solve_mincost_maxflow(const NodeIDVec &nodes, const MaxFlowE
   edgeVars.reserve(edges.size());
 
   MILPSolver solver{"MinCostFlowSolver", SolverSense::MINIMIZE};
+  solver.setNetworkFastPath(true);
 
   for (auto node : nodes)
   {
@@ -55,6 +56,8 @@ void milp_examples::solve_mincost_maxflow(const NodeIDVec &nodes, const MaxFlowE
     cost += flowValue * edge.cost;
   }
   std::cout << "Total cost is " << cost << "." << std::endl;
+  // every edge variable leaves one node row and enters another, thus the network simplex was called directly
+  std::cout << "Solved as network flow problem in " << solver.getLPSolution().nbIterations << " pivots." << std::endl;
 }
 
 int main()
@@ -55,7 +55,7 @@ void milp_examples::solve_n_queens_completion(fuint32_t n,
     }
   }
 
-  // create diagonal constraints (upper left to lower right)
+  // create diagonal constraints (upper left to lower right), diagonals are only added to the LP once violated
   int start = (-static_cast<int>(n)) + 2;
   int end = n - 1;
   for (int col = start; col < end; col++)
@@ -69,6 +69,7 @@ void milp_examples::solve_n_queens_completion(fuint32_t n,
       fuint32_t varIndex = boardVars.at(pos);
       solver.addToCst(constraint, varIndex);
     }
+    solver.setLazy(constraint);
   }
 
   // create diagonal constraints (upper right to lower left)
@@ -85,9 +86,38 @@ void milp_examples::solve_n_queens_completion(fuint32_t n,
       fuint32_t varIndex = boardVars.at(pos);
       solver.addToCst(constraint, varIndex);
     }
+    solver.setLazy(constraint);
+  }
+
+  // symmetries of the board (rotations and reflections) that map the placed queens onto themselves
+  auto transform = [n](fuint32_t symmetry, CoordinatePair field)
+  {
+    fuint32_t x = field.first, y = field.second;
+    if (symmetry & 1) x = n - 1 - x;  // reflection
+    if (symmetry & 2) y = n - 1 - y;  // reflection
+    if (symmetry & 4) std::swap(x, y); // transposition
+    return CoordinatePair(x, y);
+  };
+  for (fuint32_t symmetry = 1; symmetry < 8; symmetry++)
+  {
+    bool preservesQueens = std::all_of(placed_queens.begin(), placed_queens.end(),
+      [&](const CoordinatePair& queen){ return placed_queens.count(transform(symmetry, queen)) != 0; });
+    if (!preservesQueens) continue;
+
+    std::vector<fuint32_t> permutation(n * n);
+    for (fuint32_t y = 0; y < n; y++)
+    {
+      for (fuint32_t x = 0; x < n; x++)
+      {
+        auto image = transform(symmetry, CoordinatePair(x, y));
+        permutation.at(y * n + x) = image.second * n + image.first;
+      }
+    }
+    solver.createSymresack(VariableSpan{boardVars}, permutation);
   }
 
   solver.solve();
+  std::cout << solver.getNbLazyRowsAdded() << " of " << solver.getNbRows(LAZY_ROW) << " diagonals were added to the LP." << std::endl;
 
   // Check solution
   std::cout << (solver.getSolution() != nullptr ? "Sucess!" : "An error occurred...") << std::endl;
@@ -127,5 +157,7 @@ int main()
   };
 
   milp_examples::solve_n_queens_completion(8, placedQueens);
+  // without queens placed, all symmetries of the board are handled
+  milp_examples::solve_n_queens_completion(8, std::set<CoordinatePair>{});
 }
 
@@ -0,0 +1,72 @@
+#include "milp_examples.hpp"
+
+using namespace scip_wrapper;
+using namespace milp_examples;
+
+/*
+ * Order a given demand from suppliers with piecewise linear (volume discount) costs.
+ * The costs are modelled by convex combinations of the breakpoints with the lambda
+ * variables of each supplier forming a SOS2 (at most two adjacent lambdas nonzero).
+ * At most maxSuppliers suppliers may be used (cardinality constraint on the amounts).
+ */
+
+void milp_examples::piecewise_linear_cost(const std::vector<PiecewiseLinearCost> &suppliers,
+                                          double demand, fuint32_t maxSuppliers)
+{
+  MILPSolver solver{"PiecewiseLinearCostSolver", SolverSense::MINIMIZE};
+
+  fuint32_t demandCst = solver.createLinearConstraintEq(demand);
+  std::vector<fuint32_t> amountVars{};
+  amountVars.reserve(suppliers.size());
+  for (const auto &supplier : suppliers)
+  {
+    fuint32_t amountVar = solver.createVar(CONTINUOUS, 0.0, supplier.breakpoints.back().first, 0.0);
+    solver.addToCst(demandCst, amountVar);
+    amountVars.push_back(amountVar);
+
+    // amount = sum q_j * lambda_j, sum lambda_j = 1, cost = sum c_j * lambda_j
+    fuint32_t convexityCst = solver.createLinearConstraintEq(1.0);
+    fuint32_t amountCst = solver.createLinearConstraintEq(0.0);
+    solver.addToCst(amountCst, amountVar, -1.0);
+
+    std::vector<fuint32_t> lambdaVars{};
+    std::vector<double> weights{};
+    for (const auto &breakpoint : supplier.breakpoints)
+    {
+      fuint32_t lambdaVar = solver.createVar(CONTINUOUS, 0.0, 1.0, breakpoint.second);
+      solver.addToCst(convexityCst, lambdaVar);
+      solver.addToCst(amountCst, lambdaVar, breakpoint.first);
+      lambdaVars.push_back(lambdaVar);
+      weights.push_back(breakpoint.first);
+    }
+    solver.createSOS2(lambdaVars, weights);
+  }
+  solver.createCardinalityConstraint(amountVars, maxSuppliers);
+
+  if (!solver.solve())
+  {
+    std::cerr << "Demand cannot be satisfied." << std::endl;
+    return;
+  }
+
+  for (fuint32_t i = 0; i < suppliers.size(); i++)
+  {
+    double amount = solver.getVariableValue(amountVars.at(i));
+    if (amount < 1e-6) continue;
+    std::cout << "Order " << amount << " from " << suppliers.at(i).name << std::endl;
+  }
+  std::cout << "Total cost: " << SCIPgetSolOrigObj(solver.getModel(), solver.getSolution()) << std::endl;
+}
+
+int main()
+{
+  // breakpoints are (amount, cost), costs per unit decrease with the amount ordered
+  std::vector<PiecewiseLinearCost> suppliers
+  {
+    PiecewiseLinearCost{"SupplierA", {{0, 0}, {100, 1000}, {300, 2400}, {600, 4200}}},
+    PiecewiseLinearCost{"SupplierB", {{0, 0}, {200, 1700}, {400, 3000}, {800, 5400}}},
+    PiecewiseLinearCost{"SupplierC", {{0, 0}, {50, 400}, {250, 1800}, {500, 3400}}},
+    PiecewiseLinearCost{"SupplierD", {{0, 0}, {300, 2700}, {700, 5500}}}
+  };
+  milp_examples::piecewise_linear_cost(suppliers, 900.0, 2);
+}
@@ -5,23 +5,16 @@
 using namespace scip_wrapper;
 using namespace milp_examples;
 
-const double sufficientlyLarge = 1000000.0;
-
 namespace
 {
   const std::string svgColors[] = {"red", "blue", "cyan", "purple", "green", "yellow", "pink", "gray", "orange", "darkgreen", "darkred"};
   fuint32_t createCst(MILPSolver &solver, double length, fuint32_t xA, fuint32_t xB)
-  {
+  { // cstVar = 1 => xB - xA >= length
     fuint32_t cstVar = solver.createBinaryVar(0.0);
-    fuint32_t cstLowerCst = solver.createLinearConstraintLeq(length);
-    fuint32_t cstUpperCst = solver.createLinearConstraintLeq(sufficientlyLarge - EPSILON - length);
-    solver.addToCst(cstLowerCst, xB);
-    solver.addToCst(cstLowerCst, xA, -1.0);
-    solver.addToCst(cstLowerCst, cstVar, -sufficientlyLarge);
-
-    solver.addToCst(cstUpperCst, xA);
-    solver.addToCst(cstUpperCst, xB, -1.0);
-    solver.addToCst(cstUpperCst, cstVar, sufficientlyLarge);
+    LinearRow separated{length, INF_BOUND};
+    separated.addVariable(xB);
+    separated.addVariable(xA, -1.0);
+    solver.createIndicatorConstraint(cstVar, true, separated);
     return cstVar;
   }
 
@@ -63,7 +56,7 @@ namespace
   }
 }
 
-void milp_examples::rectangle_packing(std::vector<rectangle_t>& rects, double xLength, double yLength)
+void milp_examples::rectangle_packing(std::vector<rectangle_t>& rects, double xLength, double yLength, fuint32_t threads)
 {
   MILPSolver solver{"RectPacking", SolverSense::MINIMIZE};
 
@@ -81,16 +74,20 @@ void milp_examples::rectangle_packing(std::vector<rectangle_t>& rects, double xL
     coordVars.push_back(std::make_pair(x, y));
     includedVars.push_back(includedVar);
 
-    // create inside board constraints
-    fuint32_t xInBoardCst = solver.createLinearConstraintLeq(xLength - rect.x_length);
-    solver.addToCst(xInBoardCst, x);
-    solver.addToCst(xInBoardCst, includedVar, -sufficientlyLarge);
+    // create inside board constraints (includedVar = 0 means the rect is placed on the board)
+    LinearRow xInBoard{-INF_BOUND, xLength - rect.x_length};
+    xInBoard.addVariable(x);
+    solver.createIndicatorConstraint(includedVar, false, xInBoard);
 
-    fuint32_t yInBoardCst = solver.createLinearConstraintLeq(yLength - rect.y_length);
-    solver.addToCst(yInBoardCst, y);
-    solver.addToCst(yInBoardCst, includedVar, -sufficientlyLarge);
+    LinearRow yInBoard{-INF_BOUND, yLength - rect.y_length};
+    yInBoard.addVariable(y);
+    solver.createIndicatorConstraint(includedVar, false, yInBoard);
   }
 
+  // first decide which rects are placed (trying to place them first), then how they are separated
+  solver.setBranching(includedVars, 2, BRANCH_DOWN);
+  solver.setDefaultBranching(1);
+
   // now create constraints to enforce rects not to overlap
   for (fuint32_t i = 0; i < rects.size(); i++)
   {
@@ -123,14 +120,40 @@ void milp_examples::rectangle_packing(std::vector<rectangle_t>& rects, double xL
       solver.addToCst(nonOverlappingCst, cst2Var);
       solver.addToCst(nonOverlappingCst, cst3Var);
       solver.addToCst(nonOverlappingCst, cst4Var);
+      // most pairs of rects never come close, thus the row is only added once it is violated
+      // (user plugins are not copied, thus the decomposed solve keeps the rows in the LP)
+      if (threads == 1) solver.setLazy(nonOverlappingCst);
     }
   }
 
-  // now solve and return results
-  if (!solver.solve())
+  // among the undecided rects, the largest one is decided first (the decomposed solve rejects plugins)
+  std::map<fuint32_t, double> rectAreas{};
+  for (fuint32_t i = 0; i < rects.size(); i++) rectAreas.insert(std::make_pair(includedVars[i], rects[i].getArea()));
+  if (threads == 1)
+  {
+    solver.addBranchingRule([&](SolutionView, VariableSpan candidates)
+    {
+      fuint32_t branchVar = NO_VARIABLE;
+      double largestArea = 0.0;
+      for (auto candidate : candidates)
+      {
+        auto it = rectAreas.find(candidate);
+        if (it == rectAreas.end() || it->second <= largestArea) continue;
+        branchVar = candidate;
+        largestArea = it->second;
+      }
+      return branchVar;
+    }, "largest_rect");
+  }
+
+  // now solve and return results, the decomposed solve splits on whether the largest rects are placed
+  // (the included variables have the highest branching priority and are chosen automatically)
+  if (!(threads == 1 ? solver.solve() : solver.solveDecomposed(threads)))
   {
     std::cerr << "Error, something failed unexpectedly..." << std::endl;
   }
+  solver.printRowStatistics(std::cout);
+  std::cout << solver.getNbLazyRowsAdded() << " lazy rows were added to the LP." << std::endl;
 
   double areaUsed = 0.0;
   for (fuint32_t i = 0; i < rects.size(); i++)
@@ -168,4 +191,6 @@ int main()
   };
   milp_examples::rectangle_packing(rects, WIDTH, HEIGHT);
   createSVGFile("rectanglePackingTest.svg", rects, WIDTH, HEIGHT);
+
+  milp_examples::rectangle_packing(rects, WIDTH, HEIGHT, 4);
 }
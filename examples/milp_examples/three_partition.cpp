@@ -7,6 +7,7 @@ using namespace milp_examples;
 /* keksklauer4 19.03.2021
  *
  * Solving the 3-Partition problem using an ILP.
+ * The triplet variables are generated by column generation (branch-and-price).
  */
 
 struct Triplet
@@ -39,29 +40,42 @@ void milp_examples::three_partition(const std::vector<fuint32_t> &numbers)
   std::vector<fuint32_t> numberCsts{};
   numberCsts.resize(numbers.size());
 
-  fuint32_t index = 0;
   for (auto& numberCst : numberCsts)
   { // every number used exactly once
     numberCst = solver.createLinearConstraintEq(1.0);
   }
 
+  // triplets are priced: only columns with a positive reduced cost (farkas value) are created
   fuint32_t n = numbers.size();
-  std::map<fuint32_t, Triplet> triplets{};
-  for (fuint32_t i = 0; i < n; i++)
+  std::map<fuint32_t, std::vector<fuint32_t>> indicesOfNumber{};
+  for (fuint32_t i = 0; i < n; i++) indicesOfNumber[numbers.at(i)].push_back(i);
+  auto tripletOf = [n](fuint32_t tag) { return Triplet{tag / (n * n), (tag / n) % n, tag % n}; };
+
+  solver.addPricer([&](CoefficientSpan duals, bool farkas)
   {
-    for (fuint32_t j = i+1; j < n; j++)
+    PricedColumnVec columns{};
+    for (fuint32_t i = 0; i < n; i++)
     {
-      for (fuint32_t k = j + 1; k < n; k++)
-      {
-        if (numbers.at(i)+numbers.at(j)+numbers.at(k) != t) continue;
-        fuint32_t tripletVar = solver.createBinaryVar(1.0);
-        solver.addToCst(numberCsts.at(i), tripletVar);
-        solver.addToCst(numberCsts.at(j), tripletVar);
-        solver.addToCst(numberCsts.at(k), tripletVar);
-        triplets.insert(std::make_pair(tripletVar, Triplet{i, j, k}));
+      for (fuint32_t j = i + 1; j < n; j++)
+      { // the third number is determined by the first two
+        if (numbers.at(i) + numbers.at(j) >= t) continue;
+        auto third = indicesOfNumber.find(t - numbers.at(i) - numbers.at(j));
+        if (third == indicesOfNumber.end()) continue;
+        for (auto k : third->second)
+        {
+          if (k <= j) continue;
+          double dualSum = duals[i] + duals[j] + duals[k];
+          if (farkas ? dualSum <= 0.0 : 1.0 - dualSum <= 0.0) continue;
+          PricedColumn column{(i * n + j) * n + k, 1.0};
+          column.addCoefficient(i);
+          column.addCoefficient(j);
+          column.addCoefficient(k);
+          columns.push_back(column);
+        }
       }
     }
-  }
+    return columns;
+  }, numberCsts, "triplets");
 
   if (!solver.solve())
   {
@@ -70,17 +84,16 @@ void milp_examples::three_partition(const std::vector<fuint32_t> &numbers)
   }
 
   fuint32_t amountTriplets = 0;
-  for (const auto &triplet : triplets)
+  for (const auto &column : solver.getPricedColumnValues())
   {
-    if (solver.getBinaryValue(triplet.first))
-    {
-      std::cout << "Triplet [" << triplet.second.i << "," << triplet.second.j << "," << triplet.second.k << "]: "
-                << numbers.at(triplet.second.i) << " + " << numbers.at(triplet.second.j) << " + "
-                << numbers.at(triplet.second.k) << " = " << t << std::endl;
-      amountTriplets++;
-    }
+    if (column.second < 0.5) continue;
+    Triplet triplet = tripletOf(column.first);
+    std::cout << "Triplet [" << triplet.i << "," << triplet.j << "," << triplet.k << "]: "
+              << numbers.at(triplet.i) << " + " << numbers.at(triplet.j) << " + "
+              << numbers.at(triplet.k) << " = " << t << std::endl;
+    amountTriplets++;
   }
-  std::cout << amountTriplets << " triplets found." << std::endl;
+  std::cout << amountTriplets << " triplets found (" << solver.getNbPricedColumns() << " columns priced)." << std::endl;
 }
 
 int main()
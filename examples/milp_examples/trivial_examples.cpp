@@ -37,11 +37,26 @@ namespace examples
     MILPSolver solver{"modelName", SolverSense::MAXIMIZE};
     fuint32_t varAIndex = solver.createIntVarUpperBounded(10.0);
     fuint32_t varBIndex = solver.createIntVarUpperBounded(10.0);
-    solver.createUnequalConstraint(varAIndex, varBIndex, 10.0);
+    solver.createUnequalConstraint(varAIndex, varBIndex);
     solver.solve();
     std::cout << "Value of A: " << solver.getVariableValue(varAIndex) << std::endl;
     std::cout << "Value of B: " << solver.getVariableValue(varBIndex) << std::endl;
   }
+
+  void example3()
+  { // One-sided row with a negative leading coefficient: -x_a + x_b <= 0 is upgraded to the varbound 0 <= x_a - x_b,
+    // the optimum is x_a = 4.5 and x_b = 4.0
+    MILPSolver solver{"modelName", SolverSense::MAXIMIZE};
+    fuint32_t varAIndex = solver.createVar(VariableType::CONTINUOUS, 0.0, 4.5, 1.0);
+    fuint32_t varBIndex = solver.createIntVar(0.0, 10.0, 1.0);
+    fuint32_t constraint = solver.createLinearConstraintLeq(0.0);
+    solver.addToCst(constraint, varAIndex, -1.0);
+    solver.addToCst(constraint, varBIndex);
+    if (!solver.solve()) throw std::runtime_error("Upgraded varbound row must be feasible...");
+    std::cout << "Value of A: " << solver.getVariableValue(varAIndex) << std::endl;
+    std::cout << "Value of B: " << solver.getVariableValue(varBIndex) << std::endl;
+    solver.printRowStatistics(std::cout);
+  }
 } // namespace examples
 
 
@@ -49,5 +64,6 @@ int main()
 {
   examples::example1();
   examples::example2();
+  examples::example3();
   return 0;
 }
\ No newline at end of file
@@ -6,19 +6,86 @@ using namespace milp_examples;
 /* keksklauer4 18.03.2021
  *
  * ILP example of the general TSP.
- * The formulation is called the Miller–Tucker–Zemlin formulation.
+ * Subtours are either eliminated lazily (Dantzig–Fulkerson–Johnson formulation, the
+ * subtour elimination rows are generated by a lazy constraint callback) or by
+ * the Miller–Tucker–Zemlin formulation.
  */
 
+namespace
+{
+  std::vector<LinearRow> findSubtours(const std::vector<fuint32_t> &nodes, const std::vector<EdgeWithCost> &edges,
+                                      const std::vector<fuint32_t> &edgeVars, SolutionView values)
+  { // follows the successors of the (integral part of the) solution and cuts off every cycle not visiting all nodes
+    std::map<fuint32_t, fuint32_t> successors{};
+    for (fuint32_t i = 0; i < edges.size(); i++)
+    {
+      if (values[edgeVars[i]] > 0.5) successors[edges[i].fromNode] = edges[i].toNode;
+    }
+
+    std::vector<LinearRow> rows{};
+    std::set<fuint32_t> visited{};
+    for (auto node : nodes)
+    {
+      if (visited.count(node) != 0) continue;
+      std::set<fuint32_t> subtour{};
+      fuint32_t current = node;
+      while (visited.count(current) == 0 && successors.count(current) != 0)
+      {
+        visited.insert(current);
+        subtour.insert(current);
+        current = successors[current];
+      }
+      if (current != node || subtour.size() == nodes.size()) continue; // no cycle or a hamiltonian cycle
+
+      LinearRow row{-INF_BOUND, subtour.size() - 1.0};
+      for (fuint32_t i = 0; i < edges.size(); i++)
+      {
+        if (subtour.count(edges[i].fromNode) != 0 && subtour.count(edges[i].toNode) != 0)
+        {
+          row.addVariable(edgeVars[i]);
+        }
+      }
+      rows.push_back(row);
+    }
+    return rows;
+  }
+
+  void addOrderConstraints(MILPSolver &solver, const std::vector<fuint32_t> &nodes, const std::vector<EdgeWithCost> &edges,
+                           const std::vector<fuint32_t> &edgeVars, fuint32_t startNode)
+  { // Miller–Tucker–Zemlin: the order of a node is larger than the order of its predecessor
+    double n = nodes.size();
+    std::map<fuint32_t, fuint32_t> orderVars{};
+    for (auto node : nodes)
+    {
+      if (node == startNode)
+      { // order variable must be 1 for the start node.
+        orderVars.insert(std::make_pair(node, solver.createVar(VariableType::CONTINUOUS, 1.0, 1.0, 0.0)));
+      }
+      else
+      {
+        orderVars.insert(std::make_pair(node, solver.createIntVar(2.0, n, 0.0)));
+      }
+    }
+
+    for (fuint32_t i = 0; i < edges.size(); i++)
+    {
+      const auto &edge = edges[i];
+      if (edge.toNode == startNode) continue; // no order constraint for last edge
+      fuint32_t orderCst = solver.createLinearConstraintLeq(n - 1.0);
+      solver.addToCst(orderCst, orderVars[edge.toNode], -1.0);
+      solver.addToCst(orderCst, orderVars[edge.fromNode]);
+      solver.addToCst(orderCst, edgeVars[i], n);
+    }
+  }
+}
+
 void milp_examples::travelling_salesman_problem(const std::vector<fuint32_t> &nodes,
                                  const std::vector<EdgeWithCost> &edges,
-                                 fuint32_t startNode)
+                                 fuint32_t startNode, bool lazySubtourElimination)
 {
-  std::map<fuint32_t, fuint32_t> orderVars{};
   std::vector<fuint32_t> edgeVars{};
   // pair is <inflow, outflow>
   std::map<fuint32_t, std::pair<fuint32_t, fuint32_t>> nodeCsts{};
-
-  double n = nodes.size();
   edgeVars.reserve(edges.size());
 
   MILPSolver solver{"TspSolver", SolverSense::MINIMIZE};
@@ -28,72 +95,60 @@ void milp_examples::travelling_salesman_problem(const std::vector<fuint32_t> &no
     fuint32_t inflowCst  = solver.createLinearConstraintEq(1.0, "inflow");
     fuint32_t outflowCst = solver.createLinearConstraintEq(1.0, "outflow");
     nodeCsts.insert(std::make_pair(node, std::make_pair(inflowCst, outflowCst)));
-
-    fuint32_t orderVar;
-    if (node == startNode)
-    { // order variable must be 1 for the start node.
-      orderVar = solver.createVar(VariableType::CONTINUOUS, 1.0, 1.0, 0.0);
-    }
-    else
-    {
-      orderVar = solver.createIntVar(2.0, n, 0.0);
-    }
-    orderVars.insert(std::make_pair(node, orderVar));
   }
 
   for (const auto& edge : edges)
   {
-    auto nodeFromCst = nodeCsts[edge.fromNode];
-    auto nodeToCst = nodeCsts[edge.toNode];
-
     fuint32_t edgeVar = solver.createBinaryVar(edge.cost);
-    solver.addToCst(nodeFromCst.first, edgeVar);
-    solver.addToCst(nodeToCst.second, edgeVar);
+    solver.addToCst(nodeCsts[edge.fromNode].first, edgeVar);
+    solver.addToCst(nodeCsts[edge.toNode].second, edgeVar);
     edgeVars.push_back(edgeVar);
-
-    if (edge.toNode == startNode) continue; // no order constraint for last edge
-    // now generate ordering constraint
-    fuint32_t orderCst = solver.createLinearConstraintLeq(n - 1.0);
-    fuint32_t nodeFromOrderVar = orderVars[edge.fromNode];
-    fuint32_t nodeToOrderVar = orderVars[edge.toNode];
-    solver.addToCst(orderCst, nodeToOrderVar, -1.0);
-    solver.addToCst(orderCst, nodeFromOrderVar);
-    solver.addToCst(orderCst, edgeVar, n);
   }
+  // deciding edges is much more effective than branching on the order variables
+  solver.setBranching(edgeVars, 10);
 
-  if (!solver.solve())
+  if (lazySubtourElimination)
   {
-    std::cout << "Problem is probably infeasible." << std::endl;
+    solver.addLazyConstraintCallback([&](SolutionView values)
+    {
+      return findSubtours(nodes, edges, edgeVars, values);
+    });
   }
-
-  std::vector<std::pair<fuint32_t, fuint32_t>> order{};
-  order.reserve(orderVars.size());
-  for (fuint32_t i = 0; i < n; i++)
+  else
   {
-    order.push_back(std::make_pair(solver.getVariableValue(orderVars.at(i)), nodes.at(i)));
+    addOrderConstraints(solver, nodes, edges, edgeVars, startNode);
   }
-  std::sort(order.begin(), order.end());
 
-  for (auto it = order.begin(); it != order.end(); ++it)
+  if (!solver.solve())
   {
-    std::cout << it->second;
-    if (it + 1 == order.end()) continue;
-    std::cout << "-->";
+    std::cout << "Problem is probably infeasible." << std::endl;
+    return;
   }
-  std::cout << std::endl;
+
+  std::map<fuint32_t, fuint32_t> successors{};
   double totalDistance = 0.0;
   for (fuint32_t i = 0; i < edges.size(); i++)
   {
     if (solver.getBinaryValue(edgeVars.at(i)))
     {
       const auto& edge = edges.at(i);
+      successors[edge.fromNode] = edge.toNode;
       totalDistance += edge.cost;
       std::cout << "Edge " << edge.fromNode << "---[" << edge.cost
                 << "]--->" << edge.toNode << std::endl;
     }
   }
 
+  std::cout << startNode;
+  for (fuint32_t node = successors[startNode]; node != startNode; node = successors[node])
+  {
+    std::cout << "-->" << node;
+  }
+  std::cout << std::endl;
+
   std::cout << "Total distance travelled: " << totalDistance << std::endl;
+  std::cout << (lazySubtourElimination ? "DFJ (lazy): " : "MTZ: ") << solver.getNbNodes() << " nodes, "
+            << solver.getSolvingTime() << "s, " << solver.getNbLazyRowsAdded() << " lazy rows" << std::endl;
 }
 
 namespace
@@ -130,5 +185,6 @@ int main()
    4, 6, 2, 4, 3, 0
   };
   auto edges = createEdgeCostVec(nodes, edgeCosts);
-  milp_examples::travelling_salesman_problem(nodes, edges, 0);
+  milp_examples::travelling_salesman_problem(nodes, edges, 0, true);
+  milp_examples::travelling_salesman_problem(nodes, edges, 0, false);
 }
\ No newline at end of file
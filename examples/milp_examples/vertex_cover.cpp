@@ -1,4 +1,5 @@
 #include "milp_examples.hpp"
+#include "../../src/scip_cache.hpp"
 
 using namespace scip_wrapper;
 using namespace milp_examples;
@@ -9,9 +10,10 @@ using namespace milp_examples;
  */
 
 void milp_examples::solve_minimum_vertex_cover(std::vector<EdgePair> &edges,
-                                std::vector<double> weights)
+                                std::vector<double> weights, PortfolioStatistics *portfolio, SolutionCache *cache)
 {
   MILPSolver solver{"mvc_model", SolverSense::MINIMIZE};
+  solver.setCache(cache);
 
   // reserve space for variables and constraints:
   solver.setNbVars(weights.size());
@@ -34,7 +36,12 @@ void milp_examples::solve_minimum_vertex_cover(std::vector<EdgePair> &edges,
     solver.addToCst(cstIndex, variables.at(pairIt->second));
   }
 
-  solver.solve();
+  if (portfolio == nullptr) solver.solve();
+  else
+  { // race the best configs of the earlier instances
+    const auto configs = portfolio->nbRaces < 2 ? createDefaultPortfolio(8) : portfolio->prune(createDefaultPortfolio(8), 4);
+    solver.solvePortfolio(configs, 4, portfolio);
+  }
 
   std::cout << (solver.getSolution() != nullptr ? "Sucess!" : "An error occurred...") << std::endl;
 
@@ -75,4 +82,14 @@ int main()
 
   milp_examples::solve_minimum_vertex_cover(edges, weights);
 
+  // the same shard raced several times, the portfolio shrinks to the configs winning most often
+  PortfolioStatistics portfolio{};
+  for (fuint32_t i = 0; i < 4; i++) milp_examples::solve_minimum_vertex_cover(edges, weights, &portfolio);
+  portfolio.print(std::cout);
+
+  // the second solve of the same shard is answered by the cache
+  SolutionCache cache{};
+  for (fuint32_t i = 0; i < 2; i++) milp_examples::solve_minimum_vertex_cover(edges, weights, nullptr, &cache);
+  cache.printStatistics(std::cout);
+
 }
\ No newline at end of file
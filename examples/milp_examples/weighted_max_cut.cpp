@@ -1,8 +1,99 @@
 #include "milp_examples.hpp"
+#include "../../src/scip_builder.hpp"
+
+#include <queue>
 
 using namespace scip_wrapper;
 using namespace milp_examples;
 
+namespace
+{
+  struct Arc
+  {
+    fuint32_t target;
+    fuint32_t edgeIndex;
+    bool switchesSide; // edge is in the odd subset F of the cycle
+  };
+
+  /* Odd cycle inequalities: a cycle is cut by an even number of edges, thus for a cycle C and F subset of C
+   * with |F| odd: sum_{e in F} (1 - y_e) + sum_{e in C\F} y_e >= 1.
+   * They are separated exactly (Barahona & Mahjoub) using shortest paths in a graph with two copies of every node,
+   * edges in F connect distinct copies. A path from the first to the second copy of a node shorter than 1 is a violated cycle.
+   */
+  std::vector<LinearRow> separateOddCycles(const std::vector<fuint32_t> &nodes, const std::vector<weight_edge_t> &edges,
+                                           const std::vector<fuint32_t> &edgeVars, SolutionView values)
+  {
+    const double tolerance = 1e-6;
+    std::map<fuint32_t, fuint32_t> nodeIndices{};
+    for (auto node : nodes) nodeIndices.insert(std::make_pair(node, nodeIndices.size()));
+
+    std::vector<std::vector<Arc>> arcs(2 * nodes.size());
+    std::vector<double> weights(edges.size());
+    for (fuint32_t i = 0; i < edges.size(); i++)
+    {
+      weights[i] = std::min(1.0, std::max(0.0, values[edgeVars[i]]));
+      fuint32_t a = nodeIndices[edges[i].fromNode];
+      fuint32_t b = nodeIndices[edges[i].toNode];
+      for (fuint32_t side = 0; side < 2; side++)
+      {
+        arcs[2 * a + side].push_back(Arc{2 * b + side, i, false});
+        arcs[2 * b + side].push_back(Arc{2 * a + side, i, false});
+        arcs[2 * a + side].push_back(Arc{2 * b + 1 - side, i, true});
+        arcs[2 * b + side].push_back(Arc{2 * a + 1 - side, i, true});
+      }
+    }
+
+    std::vector<LinearRow> cuts{};
+    std::set<std::vector<fuint32_t>> found{};
+    for (fuint32_t start = 0; start < nodes.size(); start++)
+    {
+      std::vector<double> distances(arcs.size(), INF_BOUND);
+      std::vector<std::pair<fuint32_t, const Arc*>> predecessors(arcs.size(), std::make_pair(0, nullptr));
+      std::priority_queue<std::pair<double, fuint32_t>, std::vector<std::pair<double, fuint32_t>>,
+                          std::greater<std::pair<double, fuint32_t>>> queue{};
+      distances[2 * start] = 0.0;
+      queue.push(std::make_pair(0.0, 2 * start));
+      while (!queue.empty())
+      {
+        auto current = queue.top();
+        queue.pop();
+        if (current.first > distances[current.second]) continue;
+        for (const auto &arc : arcs[current.second])
+        {
+          double length = arc.switchesSide ? 1.0 - weights[arc.edgeIndex] : weights[arc.edgeIndex];
+          if (current.first + length >= distances[arc.target]) continue;
+          distances[arc.target] = current.first + length;
+          predecessors[arc.target] = std::make_pair(current.second, &arc);
+          queue.push(std::make_pair(distances[arc.target], arc.target));
+        }
+      }
+      if (distances[2 * start + 1] >= 1.0 - tolerance) continue;
+
+      // the path may visit an edge twice, such walks are skipped
+      std::map<fuint32_t, bool> cycle{};
+      bool simple = true;
+      for (fuint32_t vertex = 2 * start + 1; vertex != 2 * start; vertex = predecessors[vertex].first)
+      {
+        const Arc *arc = predecessors[vertex].second;
+        simple = simple && cycle.insert(std::make_pair(arc->edgeIndex, arc->switchesSide)).second;
+      }
+      std::vector<fuint32_t> cycleEdges{};
+      for (const auto &edge : cycle) cycleEdges.push_back(edge.first);
+      if (!simple || !found.insert(cycleEdges).second) continue;
+
+      // sum_{e in F} y_e - sum_{e in C\F} y_e <= |F| - 1
+      LinearRow cut{-INF_BOUND, -1.0};
+      for (const auto &edge : cycle)
+      {
+        cut.addVariable(edgeVars[edge.first], edge.second ? 1.0 : -1.0);
+        if (edge.second) cut.rhs += 1.0;
+      }
+      cuts.push_back(cut);
+    }
+    return cuts;
+  }
+}
+
 void milp_examples::weighted_max_cut(const std::vector<fuint32_t>& nodes,
                                      const std::vector<weight_edge_t>& edges)
 {
@@ -16,33 +107,41 @@ void milp_examples::weighted_max_cut(const std::vector<fuint32_t>& nodes,
   }
 
   // these are continuous vars (implicitly binary) that indicate
-  // whether the edge is cut by the partitioning
-  std::vector<fuint32_t> edgeVars{};
-  edgeVars.reserve(edges.size());
-  for (const auto &edge : edges)
+  // whether the edge is cut by the partitioning, built by several threads (two vars and one row per edge)
+  std::vector<fuint32_t> edgeVars(edges.size());
+  ModelBuilder builder{solver};
+  builder.forEach(4, edges.size(), 2, 1, [&](BuildContext &context, fuint32_t i)
   {
     // create constraint to check whether cut edge
-    fuint32_t nodeAVar = nodeVars[edge.fromNode];
-    fuint32_t nodeBVar = nodeVars[edge.toNode];
-    fuint32_t helperVar = solver.createBinaryVar();
-    fuint32_t edgeCutVar = solver.createVar(CONTINUOUS, 0.0, 1.0, edge.cost);
+    const auto &edge = edges[i];
+    fuint32_t nodeAVar = nodeVars.at(edge.fromNode);
+    fuint32_t nodeBVar = nodeVars.at(edge.toNode);
+    fuint32_t helperVar = context.createBinaryVar();
+    fuint32_t edgeCutVar = context.createVar(CONTINUOUS, 0.0, 1.0, edge.cost);
 
-    fuint32_t edgeCutCst = solver.createLinearConstraintEq();
-    solver.addToCst(edgeCutCst, nodeAVar);
-    solver.addToCst(edgeCutCst, nodeBVar);
-    solver.addToCst(edgeCutCst, edgeCutVar, -1.0);
-    solver.addToCst(edgeCutCst, helperVar, -2.0);
+    fuint32_t edgeCutCst = context.createLinearConstraintEq();
+    context.addToCst(edgeCutCst, nodeAVar);
+    context.addToCst(edgeCutCst, nodeBVar);
+    context.addToCst(edgeCutCst, edgeCutVar, -1.0);
+    context.addToCst(edgeCutCst, helperVar, -2.0);
 
     // nodeAVar + nodeBVar - edgeCutVar - 2 * helperVar = 0
     // this constraint enforces that if the edge is cut (thus, nodeAVar + nodeBVar = 1),
     // <=> edgeCutVar = 1 and helperVar = 0
-    edgeVars.push_back(edgeCutVar);
-  }
+    edgeVars[i] = edgeCutVar;
+  });
+  solver.merge(builder);
+
+  solver.addSeparator([&](SolutionView values)
+  {
+    return separateOddCycles(nodes, edges, edgeVars, values);
+  }, 1000, 1, "odd_cycle");
 
   if (!solver.solve())
   {
     std::cerr << "An error occurred." << std::endl;
   }
+  solver.printSeparatorStatistics(std::cout);
 
   std::cout << "Printing solution" << std::endl;
   double totalWeight = 0.0;
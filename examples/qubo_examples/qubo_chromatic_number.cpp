@@ -11,7 +11,7 @@ using namespace qubo_examples;
 void qubo_examples::chromatic_number(const std::vector<fuint32_t> &nodes,
                       const std::vector<EdgePair> &edges, fuint32_t k)
 {
-  QUBOSolver solver{SolverSense::MINIMIZE, 4.0};
+  QUBOSolver solver{SolverSense::MINIMIZE};
 
 
   std::map<fuint32_t, std::vector<fuint32_t>> colorVars{};
@@ -27,19 +27,8 @@ void qubo_examples::chromatic_number(const std::vector<fuint32_t> &nodes,
     colorVars.insert(std::make_pair(node, vars));
   }
   for (auto node : nodes)
-  {
-    auto it = colorVars.find(node);
-    for (auto varIt = it->second.begin(); varIt != it->second.end(); varIt++)
-    {
-      solver.addLinearTerm(*varIt, -1.0, true);
-    }
-    for (fuint32_t i = 0; i < k; i++)
-    {
-      for (fuint32_t j = i + 1; j < k; j++)
-      {
-        solver.addQuadraticTerm(it->second[i], it->second[j], 2.0, true);
-      }
-    }
+  { // every node has exactly one color
+    solver.addOneHot(colorVars[node]);
   }
 
   for (const auto& edge : edges)
@@ -72,6 +61,46 @@ void qubo_examples::chromatic_number(const std::vector<fuint32_t> &nodes,
   }
 }
 
+fuint32_t qubo_examples::chromatic_number_search(const std::vector<fuint32_t> &nodes,
+                      const std::vector<EdgePair> &edges)
+{ // start with one color per node and forbid the largest color until the coloring breaks
+  QUBOSolver solver{SolverSense::MINIMIZE};
+  fuint32_t k = nodes.size();
+
+  std::map<fuint32_t, std::vector<fuint32_t>> colorVars{};
+  for (auto node : nodes)
+  {
+    std::vector<fuint32_t> vars{};
+    for (fuint32_t i = 0; i < k; i++)
+    {
+      vars.push_back(solver.createBinaryVar());
+    }
+    solver.addOneHot(vars);
+    colorVars.insert(std::make_pair(node, vars));
+  }
+  for (const auto& edge : edges)
+  {
+    for (fuint32_t i = 0; i < k; i++)
+    {
+      solver.addNandTerm(colorVars[edge.first][i], colorVars[edge.second][i]);
+    }
+  }
+
+  // the model is only extended between the solves, the last coloring is used as warm start
+  while (k > 1)
+  { // forbid color k - 1
+    for (auto node : nodes)
+    {
+      solver.addLinearTerm(colorVars[node][k - 1], 1.0, true);
+    }
+    if (!solver.solve() || solver.isPenaltyViolated(0)) break;
+    k--;
+  }
+
+  std::cout << "Chromatic number of the graph is " << k << std::endl;
+  return k;
+}
+
 namespace
 {
   void simpleTest()
@@ -91,6 +120,7 @@ namespace
       EdgePair(4,5),
     };
     qubo_examples::chromatic_number(nodes, edges, 3);
+    qubo_examples::chromatic_number_search(nodes, edges);
   }
 
   void complexTest()
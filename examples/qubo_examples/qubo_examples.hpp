@@ -12,6 +12,9 @@ namespace qubo_examples
 
   void chromatic_number(const std::vector<fuint32_t> &nodes,
                         const std::vector<EdgePair> &edges, fuint32_t k);
+
+  fuint32_t chromatic_number_search(const std::vector<fuint32_t> &nodes,
+                                    const std::vector<EdgePair> &edges);
 }
 
 #endif
\ No newline at end of file
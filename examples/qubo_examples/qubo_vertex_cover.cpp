@@ -12,7 +12,8 @@ using namespace qubo_examples;
 void qubo_examples::solve_minimum_vertex_cover(std::vector<EdgePair> &edges,
                                 std::vector<double> weights)
 {
-  QUBOSolver solver{SolverSense::MINIMIZE, 10000000.0};
+  QUBOSolver solver{SolverSense::MINIMIZE}; // penalty is calibrated from the weights
+  solver.setAdaptivePenalty(3); // re-solve with larger penalties if the cover is incomplete
   VariableVector vars{};
   vars.resize(weights.size());
   for (fuint32_t i = 0; i < weights.size(); i++)
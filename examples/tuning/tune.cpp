@@ -0,0 +1,36 @@
+#include "../../src/scip_tuning.hpp"
+
+using namespace scip_wrapper;
+
+/*
+ * Tunes SCIP parameters over the instances of a directory and writes the best settings:
+ *   tune <instance directory> <settings file> [threads] [candidates] [time limit per run]
+ * The settings are loaded using MILPSolver::loadSettings.
+ */
+
+int main(int argc, char **argv)
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " <instance directory> <settings file> [threads] [candidates] [time limit]" << std::endl;
+    return 1;
+  }
+
+  TuningOptions options{};
+  if (argc > 3) options.nbThreads = std::stoul(argv[3]);
+  if (argc > 4) options.nbCandidates = std::stoul(argv[4]);
+  if (argc > 5) options.timeLimit = std::stod(argv[5]);
+
+  std::vector<std::string> instances = findInstances(argv[1]);
+  std::cout << "Tuning " << options.nbCandidates << " candidates on " << instances.size() << " instances..." << std::endl;
+  TuningResult result = tuneParameters(instances, createDefaultTuningSpace(), options);
+
+  std::cout << "Best settings after " << result.nbRuns << " runs (shifted geometric mean " << result.score << "s):" << std::endl;
+  for (const auto &parameter : result.config.parameters)
+  {
+    std::cout << "  " << parameter.first << " = " << parameter.second << std::endl;
+  }
+  writeSettings(result.config, argv[2]);
+  std::cout << "Settings written to " << argv[2] << std::endl;
+  return 0;
+}
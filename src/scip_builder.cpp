@@ -0,0 +1,186 @@
+#include "scip_builder.hpp"
+#include "scip_parallel.hpp"
+
+using namespace scip_wrapper;
+
+#define SLICES_PER_THREAD 4 // smaller slices balance items of different cost
+
+namespace scip_wrapper
+{
+  BuildContext::BuildContext(ModelBuilder &builder, bool fixedRanges)
+    : m_builder(builder), m_fixedRanges(fixedRanges)
+  {}
+
+  void BuildContext::addRange(std::vector<Range> &ranges, fuint32_t first, fuint32_t count, fuint32_t offset)
+  { // consecutive reservations (e.g. one at a time without contention) extend the last range
+    if (!ranges.empty())
+    {
+      Range &last = ranges.back();
+      if (last.used == last.reserved && last.first + last.reserved == first)
+      {
+        last.reserved += count;
+        return;
+      }
+      if (last.used != last.reserved) throw std::logic_error("Reserved indices were not used before reserving again...");
+    }
+    ranges.push_back(Range{first, count, 0, offset});
+  }
+
+  fuint32_t BuildContext::nextIndex(std::vector<Range> &ranges, std::atomic<fuint32_t> &counter, fuint32_t offset)
+  {
+    if (ranges.empty() || ranges.back().used == ranges.back().reserved)
+    {
+      if (m_fixedRanges) throw std::logic_error("More variables or rows created than assigned to the item...");
+      addRange(ranges, counter.fetch_add(1), 1, offset);
+    }
+    Range &range = ranges.back();
+    return range.first + range.used++;
+  }
+
+  fuint32_t BuildContext::reserveVars(fuint32_t count)
+  {
+    if (m_fixedRanges) throw std::logic_error("Indices are assigned by ModelBuilder::forEach...");
+    fuint32_t first = m_builder.m_nextVar.fetch_add(count);
+    addRange(m_varRanges, first, count, m_types.size());
+    return first;
+  }
+
+  fuint32_t BuildContext::reserveRows(fuint32_t count)
+  {
+    if (m_fixedRanges) throw std::logic_error("Indices are assigned by ModelBuilder::forEach...");
+    fuint32_t first = m_builder.m_nextRow.fetch_add(count);
+    addRange(m_rowRanges, first, count, m_rows.size());
+    return first;
+  }
+
+  fuint32_t BuildContext::createVar(VariableType type, double lower_bound, double upper_bound, double objective_coefficient)
+  {
+    fuint32_t index = nextIndex(m_varRanges, m_builder.m_nextVar, m_types.size());
+    m_types.push_back(type);
+    m_lowerBounds.push_back(lower_bound);
+    m_upperBounds.push_back(upper_bound);
+    m_objective.push_back(objective_coefficient);
+    return index;
+  }
+
+  fuint32_t BuildContext::createVarUpperBounded(VariableType type, double upper_bound, double objective_coefficient)
+  {
+    return createVar(type, -m_builder.m_infinity, upper_bound, objective_coefficient);
+  }
+
+  fuint32_t BuildContext::createVarLowerBounded(VariableType type, double lower_bound, double objective_coefficient)
+  {
+    return createVar(type, lower_bound, m_builder.m_infinity, objective_coefficient);
+  }
+
+  fuint32_t BuildContext::createBinaryVar(double objective_coefficient)
+  {
+    return createVar(BINARY, 0.0, 1.0, objective_coefficient);
+  }
+
+  fuint32_t BuildContext::createIntVar(double lower_bound, double upper_bound, double objective_coefficient)
+  {
+    return createVar(INTEGER, lower_bound, upper_bound, objective_coefficient);
+  }
+
+  fuint32_t BuildContext::createIntVarUpperBounded(double upper_bound, double objective_coefficient)
+  {
+    return createVarUpperBounded(INTEGER, upper_bound, objective_coefficient);
+  }
+
+  fuint32_t BuildContext::createIntVarLowerBounded(double lower_bound, double objective_coefficient)
+  {
+    return createVarLowerBounded(INTEGER, lower_bound, objective_coefficient);
+  }
+
+  fuint32_t BuildContext::createLinearConstraint(double lhs, double rhs)
+  {
+    fuint32_t index = nextIndex(m_rowRanges, m_builder.m_nextRow, m_rows.size());
+    m_rows.push_back(LinearRow{lhs, rhs});
+    return index;
+  }
+
+  fuint32_t BuildContext::createLinearConstraintEq(double equalVal)
+  {
+    return createLinearConstraint(equalVal, equalVal);
+  }
+
+  fuint32_t BuildContext::createLinearConstraintGeq(double lhs)
+  {
+    return createLinearConstraint(lhs, m_builder.m_infinity);
+  }
+
+  fuint32_t BuildContext::createLinearConstraintLeq(double rhs)
+  {
+    return createLinearConstraint(-m_builder.m_infinity, rhs);
+  }
+
+  void BuildContext::addToCst(fuint32_t cstIndex, fuint32_t varIndex, double coefficient)
+  {
+    if (varIndex >= m_builder.m_nextVar.load()) throw std::range_error("Out of range in adding to constraint...");
+    // the ranges of a context have increasing first indices, most rows are in the last range
+    auto range = std::upper_bound(m_rowRanges.begin(), m_rowRanges.end(), cstIndex, [](fuint32_t index, const Range &r)
+    {
+      return index < r.first;
+    });
+    if (range == m_rowRanges.begin() || cstIndex >= (range - 1)->first + (range - 1)->used)
+    {
+      throw std::range_error("Row was not created by this context...");
+    }
+    --range;
+    m_rows[range->offset + cstIndex - range->first].addVariable(varIndex, coefficient);
+    m_hash.addNonzero(cstIndex, varIndex, coefficient);
+  }
+
+  ModelBuilder::ModelBuilder(MILPSolver &solver)
+    : m_solver(solver), m_infinity(SCIPinfinity(solver.getModel())), m_firstVar(solver.getNbVars()),
+      m_firstRow(solver.getNbCsts()), m_nextVar(m_firstVar), m_nextRow(m_firstRow)
+  {}
+
+  BuildContext &ModelBuilder::createContext()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_contexts.emplace_back(new BuildContext{*this});
+    return *m_contexts.back();
+  }
+
+  void ModelBuilder::forEach(fuint32_t nbThreads, fuint32_t nbItems, fuint32_t varsPerItem, fuint32_t rowsPerItem,
+                             const std::function<void(BuildContext&, fuint32_t)> &task)
+  {
+    if (nbItems == 0) return;
+    const fuint32_t firstVar = m_nextVar.fetch_add(nbItems * varsPerItem);
+    const fuint32_t firstRow = m_nextRow.fetch_add(nbItems * rowsPerItem);
+    const fuint32_t nbSlices = std::min<fuint32_t>(nbItems, std::max<fuint32_t>(nbThreads, 1) * SLICES_PER_THREAD);
+    std::vector<BuildContext*> contexts{};
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (fuint32_t slice = 0; slice < nbSlices; slice++)
+      {
+        fuint32_t begin = nbItems * slice / nbSlices;
+        fuint32_t end = nbItems * (slice + 1) / nbSlices;
+        m_contexts.emplace_back(new BuildContext{*this, true});
+        BuildContext &context = *m_contexts.back();
+        if (varsPerItem > 0) context.m_varRanges.push_back(BuildContext::Range{firstVar + begin * varsPerItem, (end - begin) * varsPerItem, 0, 0});
+        if (rowsPerItem > 0) context.m_rowRanges.push_back(BuildContext::Range{firstRow + begin * rowsPerItem, (end - begin) * rowsPerItem, 0, 0});
+        context.m_types.reserve((end - begin) * varsPerItem);
+        context.m_rows.reserve((end - begin) * rowsPerItem);
+        contexts.push_back(&context);
+      }
+    }
+
+    WorkStealingPool pool{std::max<fuint32_t>(nbThreads, 1)};
+    pool.run(nbSlices, [&](fuint32_t slice)
+    {
+      BuildContext &context = *contexts[slice];
+      for (fuint32_t item = nbItems * slice / nbSlices; item < nbItems * (slice + 1) / nbSlices; item++)
+      {
+        task(context, item);
+        if (context.getNbVars() != (item + 1 - nbItems * slice / nbSlices) * varsPerItem
+            || context.getNbRows() != (item + 1 - nbItems * slice / nbSlices) * rowsPerItem)
+        {
+          throw std::logic_error("Item " + std::to_string(item) + " did not create the announced variables and rows...");
+        }
+      }
+    });
+  }
+}
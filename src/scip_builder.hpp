@@ -0,0 +1,110 @@
+#ifndef SCIP_BUILDER_HPP
+#define SCIP_BUILDER_HPP
+
+#include "scip_wrapper.hpp"
+
+#include <atomic>
+#include <mutex>
+
+/*
+ * Parallel model construction: every thread stages columns and rows in its own BuildContext, the indices are taken
+ * from ranges reserved atomically by the shared ModelBuilder and are final, thus rows can refer to the columns of
+ * other contexts. MILPSolver::merge moves everything into the model in one bulk step.
+ */
+
+namespace scip_wrapper
+{
+  class ModelBuilder;
+
+  class BuildContext
+  { // staging area of one thread, the methods mirror the building methods of the MILPSolver
+    public:
+      BuildContext(ModelBuilder &builder, bool fixedRanges = false);
+      BuildContext(const BuildContext&) = delete;
+
+    public:
+      // contiguous indices for the next count variables (rows), returns the first. Without reservation the indices are
+      // reserved one at a time, which is gap-free as well but depends on the scheduling of the threads.
+      fuint32_t reserveVars(fuint32_t count);
+      fuint32_t reserveRows(fuint32_t count);
+
+      fuint32_t createVar(VariableType type, double lower_bound, double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createVarUpperBounded(VariableType type, double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createVarLowerBounded(VariableType type, double lower_bound, double objective_coefficient = 0.0);
+      fuint32_t createBinaryVar(double objective_coefficient = 0.0);
+      fuint32_t createIntVar(double lower_bound, double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createIntVarUpperBounded(double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createIntVarLowerBounded(double lower_bound, double objective_coefficient = 0.0);
+
+      fuint32_t createLinearConstraint(double lhs, double rhs);
+      fuint32_t createLinearConstraintEq(double equalVal = 0.0);
+      fuint32_t createLinearConstraintGeq(double lhs);
+      fuint32_t createLinearConstraintLeq(double rhs);
+      // rows of this context only, variables of any context (or of the solver)
+      void addToCst(fuint32_t cstIndex, fuint32_t varIndex, double coefficient = 1.0);
+
+      fuint32_t getNbVars() const { return m_types.size(); }
+      fuint32_t getNbRows() const { return m_rows.size(); }
+
+    private:
+      struct Range
+      { // indices first, ..., first + reserved - 1 are staged at local positions offset, ...
+        fuint32_t first;
+        fuint32_t reserved;
+        fuint32_t used;
+        fuint32_t offset;
+      };
+
+    private:
+      fuint32_t nextIndex(std::vector<Range> &ranges, std::atomic<fuint32_t> &counter, fuint32_t offset);
+      void addRange(std::vector<Range> &ranges, fuint32_t first, fuint32_t count, fuint32_t offset);
+      friend class ModelBuilder;
+      friend class MILPSolver;
+
+    private:
+      ModelBuilder &m_builder;
+      bool m_fixedRanges; // creating more variables (rows) than assigned is an error
+      std::vector<Range> m_varRanges; // increasing first indices, the last range is filled
+      std::vector<Range> m_rowRanges;
+      std::vector<VariableType> m_types;
+      std::vector<double> m_lowerBounds;
+      std::vector<double> m_upperBounds;
+      std::vector<double> m_objective;
+      std::vector<LinearRow> m_rows;
+      ModelHash m_hash; // nonzeros only, summed up on merge
+  };
+
+  class ModelBuilder
+  { // the solver must not be changed until the builder is merged (see MILPSolver::merge)
+    public:
+      ModelBuilder(MILPSolver &solver);
+      ModelBuilder(const ModelBuilder&) = delete;
+
+    public:
+      BuildContext &createContext(); // thread-safe, the context is owned by the builder
+      // splits the items 0, ..., nbItems - 1 into slices built by nbThreads threads, each with its own context. Every
+      // item creates exactly varsPerItem variables and rowsPerItem rows (in this order within the item), thus item i gets
+      // the variables first + i * varsPerItem, ... (first = getNbVars() before the call), independent of the scheduling.
+      void forEach(fuint32_t nbThreads, fuint32_t nbItems, fuint32_t varsPerItem, fuint32_t rowsPerItem,
+                   const std::function<void(BuildContext&, fuint32_t)> &task);
+      fuint32_t getNbVars() const { return m_nextVar.load(); } // reserved so far, including the solver's variables
+      fuint32_t getNbRows() const { return m_nextRow.load(); }
+      double getInfinity() const { return m_infinity; }
+
+    private:
+      friend class BuildContext;
+      friend class MILPSolver;
+
+    private:
+      MILPSolver &m_solver;
+      double m_infinity; // SCIPinfinity, read once as the contexts must not touch the SCIP handle
+      fuint32_t m_firstVar; // number of variables (rows) of the solver when the builder was created
+      fuint32_t m_firstRow;
+      std::atomic<fuint32_t> m_nextVar;
+      std::atomic<fuint32_t> m_nextRow;
+      std::mutex m_mutex;
+      std::vector<std::unique_ptr<BuildContext>> m_contexts;
+  };
+}
+
+#endif
@@ -0,0 +1,332 @@
+#include "scip_cache.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <cstdio>
+#include <cerrno>
+
+using namespace scip_wrapper;
+
+#define SOLUTION_MAGIC "SCIPWSOL"
+#define SOLUTION_VERSION 1
+#define SOLUTION_SUFFIX ".sol"
+
+namespace
+{
+  const uint64_t LANE_SEEDS[2] = {0x243F6A8885A308D3ull, 0x13198A2E03707344ull};
+  // parameters changing which solutions count as optimal (or feasible)
+  const char *KEY_PARAMETERS[] = {"limits/gap", "limits/absgap", "numerics/feastol", "numerics/epsilon", "numerics/infinity"};
+
+  struct SolutionHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t feasible;
+    uint64_t high;
+    uint64_t low;
+    double objective;
+    uint64_t nbValues;
+  };
+
+  uint64_t mix(uint64_t x)
+  { // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+  }
+
+  uint64_t toBits(double value)
+  {
+    if (value == 0.0) value = 0.0; // -0.0 and 0.0 are the same coefficient
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  void combine(std::array<uint64_t, 2> &state, uint64_t value)
+  { // order dependent
+    for (int lane = 0; lane < 2; lane++) state[lane] = mix(state[lane] ^ (value + LANE_SEEDS[lane]));
+  }
+
+  std::size_t getEntryBytes(const CachedSolution &solution)
+  {
+    return sizeof(SolutionHeader) + solution.values.size() * sizeof(double);
+  }
+
+  bool parseKey(const std::string &hex, ModelKey &key)
+  {
+    if (hex.size() != 32 || hex.find_first_not_of("0123456789abcdef") != std::string::npos) return false;
+    key.high = std::stoull(hex.substr(0, 16), nullptr, 16);
+    key.low = std::stoull(hex.substr(16), nullptr, 16);
+    return true;
+  }
+
+  bool readSolution(const std::string &path, const ModelKey &key, CachedSolution &solution)
+  { // false for missing, damaged or foreign files
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) return false;
+    SolutionHeader header{};
+    struct stat status{};
+    bool valid = fstat(fileno(file), &status) == 0 && std::fread(&header, sizeof(header), 1, file) == 1
+      && std::memcmp(header.magic, SOLUTION_MAGIC, sizeof(header.magic)) == 0 && header.version == SOLUTION_VERSION
+      && header.high == key.high && header.low == key.low
+      // the value count is checked against the file before anything is allocated
+      && header.nbValues <= (static_cast<uint64_t>(status.st_size) - sizeof(header)) / sizeof(double)
+      && static_cast<uint64_t>(status.st_size) == sizeof(header) + header.nbValues * sizeof(double);
+    if (valid)
+    {
+      solution.feasible = header.feasible != 0;
+      solution.objective = header.objective;
+      solution.values.resize(header.nbValues);
+      valid = std::fread(solution.values.data(), sizeof(double), header.nbValues, file) == header.nbValues;
+    }
+    std::fclose(file);
+    return valid;
+  }
+
+  void writeSolution(const std::string &path, const ModelKey &key, const CachedSolution &solution)
+  { // written to a temporary file first, thus readers never see partial files
+    SolutionHeader header{};
+    std::memcpy(header.magic, SOLUTION_MAGIC, sizeof(header.magic));
+    header.version = SOLUTION_VERSION;
+    header.feasible = solution.feasible ? 1 : 0;
+    header.high = key.high;
+    header.low = key.low;
+    header.objective = solution.objective;
+    header.nbValues = solution.values.size();
+
+    std::string temporary = path + ".tmp";
+    FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) throw std::runtime_error("Cannot open " + temporary + "...");
+    bool valid = std::fwrite(&header, sizeof(header), 1, file) == 1
+      && std::fwrite(solution.values.data(), sizeof(double), solution.values.size(), file) == solution.values.size();
+    valid = std::fclose(file) == 0 && valid;
+    if (!valid || std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+      std::remove(temporary.c_str());
+      throw std::runtime_error("Error while writing " + path + "...");
+    }
+  }
+}
+
+namespace scip_wrapper
+{
+  std::string ModelKey::toString() const
+  {
+    char hex[33];
+    std::snprintf(hex, sizeof(hex), "%016" PRIx64 "%016" PRIx64, high, low);
+    return std::string{hex};
+  }
+
+  void ModelHash::addColumn(VariableType type, double lowerBound, double upperBound, double objective)
+  {
+    combine(columns, static_cast<uint64_t>(type));
+    combine(columns, toBits(lowerBound));
+    combine(columns, toBits(upperBound));
+    combine(columns, toBits(objective));
+    nbColumns++;
+  }
+
+  void ModelHash::addRow(double lhs, double rhs)
+  {
+    combine(rows, toBits(lhs));
+    combine(rows, toBits(rhs));
+    nbRows++;
+  }
+
+  void ModelHash::addNonzero(fuint32_t row, fuint32_t var, double coefficient)
+  {
+    for (int lane = 0; lane < 2; lane++)
+    {
+      nonzeros[lane] += mix(mix(mix(LANE_SEEDS[lane] ^ row) ^ var) ^ toBits(coefficient));
+    }
+    nbNonzeros++;
+  }
+
+  void ModelHash::addNonzeros(const ModelHash &other)
+  {
+    for (int lane = 0; lane < 2; lane++) nonzeros[lane] += other.nonzeros[lane];
+    nbNonzeros += other.nbNonzeros;
+  }
+
+  ModelKey ModelHash::getKey(SCIP *scip) const
+  {
+    std::array<uint64_t, 2> state{};
+    for (uint64_t value : {columns[0], columns[1], rows[0], rows[1], nonzeros[0], nonzeros[1], nbColumns, nbRows, nbNonzeros})
+    {
+      combine(state, value);
+    }
+    combine(state, static_cast<uint64_t>(SCIPgetObjsense(scip)));
+    for (const char *name : KEY_PARAMETERS)
+    {
+      double value = 0.0;
+      SCIP_CALL_EXC(SCIPgetRealParam(scip, name, &value));
+      combine(state, toBits(value));
+    }
+    ModelKey key{};
+    key.high = state[0];
+    key.low = state[1];
+    return key;
+  }
+
+  SolutionCache::SolutionCache(const CacheOptions &options)
+    : m_options(options), m_nbBytes(0), m_nbHits(0), m_nbMisses(0), m_nbEvictions(0)
+  {
+    if (m_options.directory.empty()) return;
+    if (mkdir(m_options.directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+      throw std::runtime_error("Cannot create cache directory " + m_options.directory + "...");
+    }
+    loadIndex();
+  }
+
+  std::string SolutionCache::getPath(const ModelKey &key) const
+  {
+    return m_options.directory + "/" + key.toString() + SOLUTION_SUFFIX;
+  }
+
+  void SolutionCache::loadIndex()
+  { // entries of earlier runs, the most recently used (or stored) file goes to the front
+    DIR *dir = opendir(m_options.directory.c_str());
+    if (dir == nullptr) throw std::runtime_error("Cannot open cache directory " + m_options.directory + "...");
+    std::vector<std::pair<time_t, std::pair<ModelKey, std::size_t>>> files{};
+    for (dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+    {
+      std::string name{entry->d_name};
+      ModelKey key{};
+      const std::size_t suffix = std::strlen(SOLUTION_SUFFIX);
+      if (name.size() <= suffix || name.compare(name.size() - suffix, suffix, SOLUTION_SUFFIX) != 0) continue;
+      if (!parseKey(name.substr(0, name.size() - suffix), key)) continue;
+      struct stat status{};
+      if (stat((m_options.directory + "/" + name).c_str(), &status) != 0) continue;
+      files.push_back(std::make_pair(status.st_mtime, std::make_pair(key, static_cast<std::size_t>(status.st_size))));
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end(), [](const decltype(files)::value_type &a, const decltype(files)::value_type &b)
+    {
+      return a.first < b.first;
+    });
+    for (const auto &file : files) insert(file.second.first, file.second.second, CachedSolution{});
+    evict();
+  }
+
+  void SolutionCache::insert(const ModelKey &key, std::size_t bytes, const CachedSolution &solution)
+  {
+    auto existing = m_index.find(key);
+    if (existing != m_index.end())
+    {
+      m_nbBytes -= existing->second->bytes;
+      m_entries.erase(existing->second);
+      m_index.erase(existing);
+    }
+    m_entries.push_front(Entry{key, bytes, m_options.directory.empty() ? solution : CachedSolution{}});
+    m_index[key] = m_entries.begin();
+    m_nbBytes += bytes;
+  }
+
+  void SolutionCache::remove(std::list<Entry>::iterator entry)
+  {
+    if (!m_options.directory.empty()) std::remove(getPath(entry->key).c_str());
+    m_nbBytes -= entry->bytes;
+    m_index.erase(entry->key);
+    m_entries.erase(entry);
+  }
+
+  void SolutionCache::evict()
+  {
+    while (!m_entries.empty() && (m_entries.size() > m_options.maxEntries || m_nbBytes > m_options.maxBytes))
+    {
+      remove(std::prev(m_entries.end()));
+      m_nbEvictions++;
+    }
+  }
+
+  bool SolutionCache::lookup(const ModelKey &key, CachedSolution &solution)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+    { // the file may have been stored by another process sharing the directory
+      if (m_options.directory.empty() || !readSolution(getPath(key), key, solution))
+      {
+        m_nbMisses++;
+        return false;
+      }
+      insert(key, getEntryBytes(solution), solution);
+      m_nbHits++;
+      evict();
+      return true;
+    }
+    auto entry = it->second;
+    if (m_options.directory.empty()) solution = entry->solution;
+    else if (!readSolution(getPath(key), key, solution))
+    { // removed or damaged by someone else
+      remove(entry);
+      m_nbMisses++;
+      return false;
+    }
+    if (m_options.policy == EVICT_LEAST_RECENTLY_USED)
+    {
+      m_entries.splice(m_entries.begin(), m_entries, entry);
+      if (!m_options.directory.empty()) utimes(getPath(key).c_str(), nullptr); // keeps the order for later runs
+    }
+    m_nbHits++;
+    return true;
+  }
+
+  void SolutionCache::store(const ModelKey &key, const CachedSolution &solution)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t bytes = getEntryBytes(solution);
+    if (bytes > m_options.maxBytes || m_options.maxEntries == 0) return;
+    if (!m_options.directory.empty()) writeSolution(getPath(key), key, solution);
+    insert(key, bytes, solution);
+    evict();
+  }
+
+  void SolutionCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (!m_entries.empty()) remove(m_entries.begin());
+  }
+
+  fuint32_t SolutionCache::getNbEntries() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+  }
+
+  std::size_t SolutionCache::getNbBytes() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nbBytes;
+  }
+
+  fuint32_t SolutionCache::getNbHits() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nbHits;
+  }
+
+  fuint32_t SolutionCache::getNbMisses() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nbMisses;
+  }
+
+  fuint32_t SolutionCache::getNbEvictions() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nbEvictions;
+  }
+
+  void SolutionCache::printStatistics(std::ostream &os) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    os << m_entries.size() << " cached solutions (" << m_nbBytes << " bytes), " << m_nbHits << " hits, "
+       << m_nbMisses << " misses, " << m_nbEvictions << " evictions" << std::endl;
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef SCIP_CACHE_HPP
+#define SCIP_CACHE_HPP
+
+#include "scip_wrapper.hpp"
+
+#include <list>
+#include <mutex>
+
+/*
+ * Results of earlier solves, looked up by the content hash of the model (see MILPSolver::setCache).
+ * Kept in memory or as one file per model in a directory (surviving restarts), bounded by the number of
+ * entries and their size. A cache can be shared by solvers running in several threads.
+ */
+
+namespace scip_wrapper
+{
+  enum EvictionPolicy
+  {
+    EVICT_LEAST_RECENTLY_USED, // hits move an entry to the front
+    EVICT_OLDEST               // entries are evicted in the order they were stored
+  };
+
+  struct CacheOptions
+  {
+    CacheOptions()
+      : maxEntries(1024), maxBytes(std::size_t{1} << 30), policy(EVICT_LEAST_RECENTLY_USED), directory("") {}
+
+    public:
+      fuint32_t maxEntries;
+      std::size_t maxBytes; // values and headers of all entries
+      EvictionPolicy policy;
+      std::string directory; // entries are kept on disk if not empty (created if missing)
+  };
+
+  struct CachedSolution
+  {
+    CachedSolution() : feasible(false), objective(0.0) {}
+
+    public:
+      bool feasible; // infeasible models have no values
+      double objective;
+      std::vector<double> values; // indexed by the variable indices
+  };
+
+  class SolutionCache
+  {
+    public:
+      SolutionCache(const CacheOptions &options = CacheOptions{}); // loads the index of an existing directory
+      SolutionCache(const SolutionCache&) = delete;
+
+      bool lookup(const ModelKey &key, CachedSolution &solution);
+      void store(const ModelKey &key, const CachedSolution &solution);
+      void clear(); // also removes the files
+
+      fuint32_t getNbEntries() const;
+      std::size_t getNbBytes() const;
+      fuint32_t getNbHits() const;
+      fuint32_t getNbMisses() const;
+      fuint32_t getNbEvictions() const;
+      void printStatistics(std::ostream &os) const;
+
+    private:
+      struct Entry
+      {
+        ModelKey key;
+        std::size_t bytes;
+        CachedSolution solution; // only kept in memory without a directory
+      };
+
+    private:
+      std::string getPath(const ModelKey &key) const;
+      void loadIndex();
+      void insert(const ModelKey &key, std::size_t bytes, const CachedSolution &solution);
+      void remove(std::list<Entry>::iterator entry);
+      void evict();
+
+    private:
+      CacheOptions m_options;
+      std::list<Entry> m_entries; // the back is evicted first
+      std::map<ModelKey, std::list<Entry>::iterator> m_index;
+      std::size_t m_nbBytes;
+      fuint32_t m_nbHits;
+      fuint32_t m_nbMisses;
+      fuint32_t m_nbEvictions;
+      mutable std::mutex m_mutex;
+  };
+}
+
+#endif
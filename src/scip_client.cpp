@@ -0,0 +1,227 @@
+#include "scip_client.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace scip_wrapper;
+
+namespace
+{
+  RequestHeader createHeader(ProblemKind problem, SolverSense sense, double timeLimit)
+  {
+    RequestHeader header{};
+    header.magic = PROTOCOL_MAGIC;
+    header.version = PROTOCOL_VERSION;
+    header.problem = problem;
+    header.sense = sense;
+    header.timeLimit = timeLimit;
+    return header;
+  }
+
+  bool receiveResult(DaemonConnection &connection, const std::vector<char> &request, RemoteResult &result)
+  {
+    std::vector<char> message = connection.request(request);
+    MessageReader reader{message};
+    ResponseHeader header = reader.get<ResponseHeader>();
+    if (header.magic != PROTOCOL_MAGIC) throw std::runtime_error("Response is no daemon message...");
+    result.status = static_cast<SolveStatus>(header.status);
+    result.objective = header.objective;
+    result.solvingTime = header.solvingTime;
+    result.waitingTime = header.waitingTime;
+    result.nbNodes = header.nbNodes;
+    reader.getArray(result.values, header.nbValues);
+    result.message.resize(header.messageSize);
+    reader.getArray(&result.message[0], header.messageSize);
+    if (result.status == SOLVE_ERROR) throw std::runtime_error("Daemon failed: " + result.message);
+    return result.status == SOLVE_OPTIMAL || result.status == SOLVE_FEASIBLE;
+  }
+}
+
+namespace scip_wrapper
+{
+  DaemonConnection::DaemonConnection(const std::string &socketPath)
+    : m_fd(-1)
+  {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) throw std::invalid_argument("Socket path " + socketPath + " is too long...");
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    m_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_fd < 0) throw std::runtime_error("Cannot create socket...");
+    if (connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+      close(m_fd);
+      throw std::runtime_error("Cannot connect to the daemon at " + socketPath + "...");
+    }
+  }
+
+  DaemonConnection::~DaemonConnection()
+  {
+    close(m_fd);
+  }
+
+  std::vector<char> DaemonConnection::request(const std::vector<char> &message)
+  {
+    sendMessage(m_fd, message);
+    std::vector<char> response{};
+    if (!receiveMessage(m_fd, response, std::numeric_limits<uint64_t>::max()))
+    {
+      throw std::runtime_error("Daemon closed the connection...");
+    }
+    return response;
+  }
+
+  RemoteMILPSolver::RemoteMILPSolver(DaemonConnection &connection, SolverSense sense)
+    : m_connection(connection), m_sense(sense), m_timeLimit(0.0)
+  {}
+
+  void RemoteMILPSolver::setNbVars(fuint32_t nb)
+  {
+    m_types.reserve(nb);
+    m_lowerBounds.reserve(nb);
+    m_upperBounds.reserve(nb);
+    m_objective.reserve(nb);
+  }
+
+  void RemoteMILPSolver::setNbCsts(fuint32_t nb)
+  {
+    m_lhs.reserve(nb);
+    m_rhs.reserve(nb);
+    m_rows.reserve(nb);
+  }
+
+  fuint32_t RemoteMILPSolver::createVar(VariableType type, double lower_bound, double upper_bound, double objective_coefficient)
+  {
+    m_types.push_back(type);
+    m_lowerBounds.push_back(lower_bound);
+    m_upperBounds.push_back(upper_bound);
+    m_objective.push_back(objective_coefficient);
+    return m_types.size() - 1;
+  }
+
+  fuint32_t RemoteMILPSolver::createVarUpperBounded(VariableType type, double upper_bound, double objective_coefficient)
+  {
+    return createVar(type, -INF_BOUND, upper_bound, objective_coefficient);
+  }
+
+  fuint32_t RemoteMILPSolver::createVarLowerBounded(VariableType type, double lower_bound, double objective_coefficient)
+  {
+    return createVar(type, lower_bound, INF_BOUND, objective_coefficient);
+  }
+
+  fuint32_t RemoteMILPSolver::createBinaryVar(double objective_coefficient)
+  {
+    return createVar(BINARY, 0.0, 1.0, objective_coefficient);
+  }
+
+  fuint32_t RemoteMILPSolver::createIntVar(double lower_bound, double upper_bound, double objective_coefficient)
+  {
+    return createVar(INTEGER, lower_bound, upper_bound, objective_coefficient);
+  }
+
+  fuint32_t RemoteMILPSolver::createIntVarUpperBounded(double upper_bound, double objective_coefficient)
+  {
+    return createVarUpperBounded(INTEGER, upper_bound, objective_coefficient);
+  }
+
+  fuint32_t RemoteMILPSolver::createIntVarLowerBounded(double lower_bound, double objective_coefficient)
+  {
+    return createVarLowerBounded(INTEGER, lower_bound, objective_coefficient);
+  }
+
+  fuint32_t RemoteMILPSolver::createLinearConstraint(double lhs, double rhs)
+  {
+    m_lhs.push_back(lhs);
+    m_rhs.push_back(rhs);
+    m_rows.emplace_back();
+    return m_rows.size() - 1;
+  }
+
+  fuint32_t RemoteMILPSolver::createLinearConstraintEq(double equalVal)
+  {
+    return createLinearConstraint(equalVal, equalVal);
+  }
+
+  fuint32_t RemoteMILPSolver::createLinearConstraintGeq(double lhs)
+  {
+    return createLinearConstraint(lhs, INF_BOUND);
+  }
+
+  fuint32_t RemoteMILPSolver::createLinearConstraintLeq(double rhs)
+  {
+    return createLinearConstraint(-INF_BOUND, rhs);
+  }
+
+  void RemoteMILPSolver::addToCst(fuint32_t cstIndex, fuint32_t varIndex, double coefficient)
+  {
+    if (varIndex >= m_types.size()) throw std::range_error("Variable index out of range...");
+    m_rows.at(cstIndex).push_back(std::make_pair(static_cast<uint32_t>(varIndex), coefficient));
+  }
+
+  bool RemoteMILPSolver::solve()
+  {
+    RequestHeader header = createHeader(MILP_PROBLEM, m_sense, m_timeLimit);
+    header.nbVars = m_types.size();
+    header.nbRows = m_rows.size();
+    std::vector<uint64_t> rowStarts{0};
+    rowStarts.reserve(m_rows.size() + 1);
+    for (const auto &row : m_rows) rowStarts.push_back(rowStarts.back() + row.size());
+    header.nbNonzeros = rowStarts.back();
+
+    MessageWriter writer{};
+    writer.put(header);
+    writer.putArray(m_types.data(), m_types.size());
+    writer.putArray(m_lowerBounds.data(), m_lowerBounds.size());
+    writer.putArray(m_upperBounds.data(), m_upperBounds.size());
+    writer.putArray(m_objective.data(), m_objective.size());
+    writer.putArray(m_lhs.data(), m_lhs.size());
+    writer.putArray(m_rhs.data(), m_rhs.size());
+    writer.putArray(rowStarts.data(), rowStarts.size());
+    for (const auto &row : m_rows)
+    {
+      for (const auto &entry : row) writer.put(entry.first);
+    }
+    for (const auto &row : m_rows)
+    {
+      for (const auto &entry : row) writer.put(entry.second);
+    }
+    m_result = RemoteResult{};
+    return receiveResult(m_connection, writer.getData(), m_result);
+  }
+
+  RemoteQUBOSolver::RemoteQUBOSolver(DaemonConnection &connection, SolverSense sense, double penalty)
+    : m_connection(connection), m_sense(sense), m_penalty(penalty), m_timeLimit(0.0), m_nbVars(0)
+  {}
+
+  void RemoteQUBOSolver::addQuadraticTerm(fuint32_t x, fuint32_t y, double coefficient, bool withPenalty)
+  {
+    if (x >= m_nbVars || y >= m_nbVars) throw std::range_error("Variable index out of range...");
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_coefficients.push_back(coefficient);
+    m_withPenalty.push_back(withPenalty ? 1 : 0);
+  }
+
+  void RemoteQUBOSolver::addLinearTerm(fuint32_t x, double coefficient, bool withPenalty)
+  {
+    addQuadraticTerm(x, x, coefficient, withPenalty);
+  }
+
+  bool RemoteQUBOSolver::solve()
+  {
+    RequestHeader header = createHeader(QUBO_PROBLEM, m_sense, m_timeLimit);
+    header.penalty = m_penalty;
+    header.nbVars = m_nbVars;
+    header.nbNonzeros = m_x.size();
+
+    MessageWriter writer{};
+    writer.put(header);
+    writer.putArray(m_x.data(), m_x.size());
+    writer.putArray(m_y.data(), m_y.size());
+    writer.putArray(m_coefficients.data(), m_coefficients.size());
+    writer.putArray(m_withPenalty.data(), m_withPenalty.size());
+    m_result = RemoteResult{};
+    return receiveResult(m_connection, writer.getData(), m_result);
+  }
+}
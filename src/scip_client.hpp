@@ -0,0 +1,114 @@
+#ifndef SCIP_CLIENT_HPP
+#define SCIP_CLIENT_HPP
+
+#include "scip_protocol.hpp"
+
+/*
+ * Thin client of the solve daemon (see scip_daemon.hpp), neither linked against SCIP nor including its headers.
+ * RemoteMILPSolver and RemoteQUBOSolver mirror the building methods of the MILPSolver and QUBOSolver, the model is
+ * collected locally and sent as one request on solve().
+ */
+
+namespace scip_wrapper
+{
+  class DaemonConnection
+  { // requests are answered in order, a connection is used by one thread at a time
+    public:
+      DaemonConnection(const std::string &socketPath);
+      DaemonConnection(const DaemonConnection&) = delete;
+      ~DaemonConnection();
+
+      std::vector<char> request(const std::vector<char> &message);
+
+    private:
+      int m_fd;
+  };
+
+  struct RemoteResult
+  {
+    RemoteResult() : status(SOLVE_NO_SOLUTION), objective(0.0), solvingTime(0.0), waitingTime(0.0), nbNodes(0) {}
+
+    public:
+      SolveStatus status;
+      double objective;
+      double solvingTime; // seconds, measured by the daemon
+      double waitingTime; // seconds spent in the daemon's queue
+      int64_t nbNodes;
+      std::vector<double> values; // indexed by the variable indices
+      std::string message; // reason of rejections and errors
+  };
+
+  class RemoteMILPSolver
+  {
+    public:
+      RemoteMILPSolver(DaemonConnection &connection, SolverSense sense);
+
+    public:
+      // true if a solution was found, rejected requests return false and failed requests throw
+      bool solve();
+      void setTimeLimit(double seconds) { m_timeLimit = seconds; } // includes waiting for a worker, 0 for the default
+      void setNbVars(fuint32_t nb);
+      void setNbCsts(fuint32_t nb);
+
+      fuint32_t createVar(VariableType type, double lower_bound, double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createVarUpperBounded(VariableType type, double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createVarLowerBounded(VariableType type, double lower_bound, double objective_coefficient = 0.0);
+      fuint32_t createBinaryVar(double objective_coefficient = 0.0);
+      fuint32_t createIntVar(double lower_bound, double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createIntVarUpperBounded(double upper_bound, double objective_coefficient = 0.0);
+      fuint32_t createIntVarLowerBounded(double lower_bound, double objective_coefficient = 0.0);
+
+      fuint32_t createLinearConstraint(double lhs, double rhs);
+      fuint32_t createLinearConstraintEq(double equalVal = 0.0);
+      fuint32_t createLinearConstraintGeq(double lhs);
+      fuint32_t createLinearConstraintLeq(double rhs);
+      void addToCst(fuint32_t cstIndex, fuint32_t varIndex, double coefficient = 1.0);
+
+      double getVariableValue(fuint32_t variableIndex) const { return m_result.values.at(variableIndex); }
+      bool getBinaryValue(fuint32_t variableIndex) const { return getVariableValue(variableIndex) > 0.5; }
+      const RemoteResult &getResult() const { return m_result; }
+
+    private:
+      DaemonConnection &m_connection;
+      SolverSense m_sense;
+      double m_timeLimit;
+      std::vector<uint8_t> m_types;
+      std::vector<double> m_lowerBounds;
+      std::vector<double> m_upperBounds;
+      std::vector<double> m_objective;
+      std::vector<double> m_lhs;
+      std::vector<double> m_rhs;
+      std::vector<std::vector<std::pair<uint32_t, double>>> m_rows; // sent as compressed sparse rows
+      RemoteResult m_result;
+  };
+
+  class RemoteQUBOSolver
+  {
+    public:
+      RemoteQUBOSolver(DaemonConnection &connection, SolverSense sense, double penalty = 0.0); // 0: calibrated by the daemon
+
+    public:
+      bool solve();
+      void setTimeLimit(double seconds) { m_timeLimit = seconds; }
+      fuint32_t createBinaryVar() { return m_nbVars++; }
+      void addQuadraticTerm(fuint32_t x, fuint32_t y, double coefficient = 1.0, bool withPenalty = false);
+      void addLinearTerm(fuint32_t x, double coefficient = 1.0, bool withPenalty = false);
+
+      bool getBinaryValue(fuint32_t x) const { return m_result.values.at(x) > 0.5; }
+      const RemoteResult &getResult() const { return m_result; } // the objective does not contain penalty terms
+
+    private:
+      DaemonConnection &m_connection;
+      SolverSense m_sense;
+      double m_penalty;
+      double m_timeLimit;
+      uint32_t m_nbVars;
+      std::vector<uint32_t> m_x;
+      std::vector<uint32_t> m_y;
+      std::vector<double> m_coefficients;
+      std::vector<uint8_t> m_withPenalty;
+      RemoteResult m_result;
+  };
+}
+
+#endif
@@ -0,0 +1,466 @@
+#include "scip_daemon.hpp"
+#include "scip_parallel.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace scip_wrapper;
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  double getSeconds(Clock::time_point start)
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  double toSCIPBound(SCIP *scip, double value)
+  { // clients send infinite bounds and sides as +-INF_BOUND
+    if (value == INF_BOUND) return SCIPinfinity(scip);
+    if (value == -INF_BOUND) return -SCIPinfinity(scip);
+    return value;
+  }
+
+  void checkIndices(const std::vector<uint32_t> &indices, uint64_t nbVars)
+  {
+    for (uint32_t index : indices)
+    {
+      if (index >= nbVars) throw std::range_error("Variable index " + std::to_string(index) + " out of range...");
+    }
+  }
+
+  std::vector<char> encodeResponse(const ResponseHeader &header, const std::vector<double> &values, const std::string &message)
+  {
+    MessageWriter writer{};
+    ResponseHeader response = header;
+    response.magic = PROTOCOL_MAGIC;
+    response.nbValues = values.size();
+    response.messageSize = message.size();
+    writer.put(response);
+    writer.putArray(values.data(), values.size());
+    writer.putArray(message.data(), message.size());
+    return writer.getData();
+  }
+}
+
+namespace scip_wrapper
+{
+  struct SolveDaemon::MILPModel
+  { // decoded before a worker is taken, thus malformed requests do not occupy a worker
+    std::vector<uint8_t> types;
+    std::vector<double> lowerBounds;
+    std::vector<double> upperBounds;
+    std::vector<double> objective;
+    std::vector<double> lhs;
+    std::vector<double> rhs;
+    std::vector<uint64_t> rowStarts;
+    std::vector<uint32_t> vars;
+    std::vector<double> coefficients;
+  };
+
+  struct SolveDaemon::QUBOModel
+  {
+    std::vector<uint32_t> x;
+    std::vector<uint32_t> y;
+    std::vector<double> coefficients;
+    std::vector<uint8_t> withPenalty;
+  };
+
+  void DaemonStatistics::print(std::ostream &os) const
+  {
+    os << nbConnections << " connections, " << nbRequests << " requests (" << nbRejected << " rejected, " << nbErrors
+       << " failed), " << nbSolversCreated << " solvers created" << std::endl;
+  }
+
+  SolveDaemon::SolveDaemon(const DaemonOptions &options)
+    : m_options(options), m_listenFd(-1), m_stopPipe{-1, -1}, m_stopped(false), m_nbActive(0), m_nbQueued(0)
+  {
+    if (m_options.nbWorkers == 0) throw std::invalid_argument("The daemon needs at least one worker...");
+    for (fuint32_t i = 0; i < m_options.nbWorkers; i++) m_milpSolvers.push_back(takeMILPSolver());
+
+    sockaddr_un address{};
+    if (m_options.socketPath.size() >= sizeof(address.sun_path))
+    {
+      throw std::invalid_argument("Socket path " + m_options.socketPath + " is too long...");
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, m_options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+    if (pipe(m_stopPipe) != 0) throw std::runtime_error("Cannot create the stop pipe...");
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0) throw std::runtime_error("Cannot create socket...");
+    unlink(m_options.socketPath.c_str()); // left behind by an earlier daemon
+    mode_t mask = umask(0077); // the socket is created accessible by the owner only
+    bool bound = bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    umask(mask);
+    if (!bound || listen(m_listenFd, m_options.maxConnections) != 0)
+    {
+      throw std::runtime_error("Cannot listen on " + m_options.socketPath + "...");
+    }
+  }
+
+  SolveDaemon::~SolveDaemon()
+  {
+    for (auto &connection : m_connections)
+    {
+      shutdown(connection.first, SHUT_RDWR);
+      connection.second.join();
+      close(connection.first);
+    }
+    if (m_listenFd >= 0)
+    {
+      close(m_listenFd);
+      unlink(m_options.socketPath.c_str());
+    }
+    for (int fd : m_stopPipe)
+    {
+      if (fd >= 0) close(fd);
+    }
+  }
+
+  void SolveDaemon::stop()
+  {
+    m_stopped = true;
+    char byte = 0;
+    ssize_t written = write(m_stopPipe[1], &byte, 1);
+    (void) written; // a full pipe already wakes up the accept loop
+  }
+
+  DaemonStatistics SolveDaemon::getStatistics()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+  }
+
+  void SolveDaemon::run()
+  {
+    pollfd fds[2] = {{m_listenFd, POLLIN, 0}, {m_stopPipe[0], POLLIN, 0}};
+    while (!m_stopped)
+    {
+      if (poll(fds, 2, -1) < 0)
+      {
+        if (errno == EINTR) continue;
+        throw std::runtime_error("Error while waiting for connections...");
+      }
+      joinFinished();
+      if (m_stopped || (fds[0].revents & POLLIN) == 0) continue;
+      int fd = accept(m_listenFd, nullptr, nullptr);
+      if (fd < 0) continue;
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_connections.size() >= m_options.maxConnections)
+      {
+        close(fd);
+        continue;
+      }
+      m_statistics.nbConnections++;
+      m_connections[fd] = std::thread(&SolveDaemon::serve, this, fd);
+    }
+
+    { // queued requests give up, running solves are interrupted (see includeInterruption) and answered
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto &connection : m_connections) shutdown(connection.first, SHUT_RD);
+    }
+    m_workerReleased.notify_all();
+    for (auto &connection : m_connections)
+    {
+      connection.second.join();
+      close(connection.first);
+    }
+    m_connections.clear();
+    m_finished.clear();
+  }
+
+  void SolveDaemon::joinFinished()
+  {
+    std::vector<std::thread> threads{};
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (int fd : m_finished)
+      {
+        threads.push_back(std::move(m_connections.at(fd)));
+        m_connections.erase(fd);
+        close(fd);
+      }
+      m_finished.clear();
+    }
+    for (auto &thread : threads) thread.join();
+  }
+
+  void SolveDaemon::serve(int fd)
+  { // requests of a connection are answered in order, the connection is closed on malformed frames
+    std::vector<char> request{};
+    try
+    {
+      while (!m_stopped && receiveMessage(fd, request, m_options.maxMessageSize))
+      {
+        sendMessage(fd, handle(request));
+      }
+    }
+    catch (const std::exception &e)
+    {
+      if (!m_stopped) std::cerr << "Connection closed: " << e.what() << std::endl;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished.push_back(fd);
+  }
+
+  std::vector<char> SolveDaemon::handle(const std::vector<char> &request)
+  {
+    Clock::time_point start = Clock::now();
+    ResponseHeader response{};
+    std::vector<double> values{};
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_statistics.nbRequests++;
+    }
+    try
+    {
+      MessageReader reader{request};
+      RequestHeader header = reader.get<RequestHeader>();
+      if (header.magic != PROTOCOL_MAGIC) throw std::runtime_error("Request is no daemon message...");
+      if (header.version != PROTOCOL_VERSION)
+      {
+        throw std::runtime_error("Request has protocol version " + std::to_string(header.version) + ", expected "
+                                 + std::to_string(PROTOCOL_VERSION) + "...");
+      }
+      if (header.sense != MINIMIZE && header.sense != MAXIMIZE) throw std::invalid_argument("Unknown objective sense...");
+      double budget = header.timeLimit > 0.0 ? header.timeLimit : m_options.defaultTimeLimit;
+      budget = std::min(budget, m_options.maxTimeLimit);
+
+      MILPModel milp{};
+      QUBOModel qubo{};
+      if (header.problem == MILP_PROBLEM)
+      {
+        reader.getArray(milp.types, header.nbVars);
+        reader.getArray(milp.lowerBounds, header.nbVars);
+        reader.getArray(milp.upperBounds, header.nbVars);
+        reader.getArray(milp.objective, header.nbVars);
+        reader.getArray(milp.lhs, header.nbRows);
+        reader.getArray(milp.rhs, header.nbRows);
+        reader.getArray(milp.rowStarts, header.nbRows + 1);
+        reader.getArray(milp.vars, header.nbNonzeros);
+        reader.getArray(milp.coefficients, header.nbNonzeros);
+        for (uint8_t type : milp.types)
+        {
+          if (type > CONTINUOUS) throw std::invalid_argument("Unknown variable type...");
+        }
+        if (milp.rowStarts.front() != 0 || milp.rowStarts.back() != header.nbNonzeros
+            || !std::is_sorted(milp.rowStarts.begin(), milp.rowStarts.end()))
+        {
+          throw std::invalid_argument("Row starts are not increasing...");
+        }
+        checkIndices(milp.vars, header.nbVars);
+      }
+      else if (header.problem == QUBO_PROBLEM)
+      {
+        reader.getArray(qubo.x, header.nbNonzeros);
+        reader.getArray(qubo.y, header.nbNonzeros);
+        reader.getArray(qubo.coefficients, header.nbNonzeros);
+        reader.getArray(qubo.withPenalty, header.nbNonzeros);
+        checkIndices(qubo.x, header.nbVars);
+        checkIndices(qubo.y, header.nbVars);
+      }
+      else throw std::invalid_argument("Unknown problem kind...");
+      if (!reader.atEnd()) throw std::runtime_error("Request has trailing bytes...");
+
+      if (!acquireWorker(budget - getSeconds(start), response.waitingTime))
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_statistics.nbRejected++;
+        response.status = SOLVE_REJECTED;
+        return encodeResponse(response, values, "No worker available within the time budget...");
+      }
+      try
+      {
+        double timeLimit = std::max(budget - getSeconds(start), 0.0);
+        if (header.problem == MILP_PROBLEM) solveMILP(milp, header, timeLimit, response, values);
+        else solveQUBO(qubo, header, timeLimit, response, values);
+      }
+      catch (...)
+      {
+        releaseWorker();
+        throw;
+      }
+      releaseWorker();
+      return encodeResponse(response, values, "");
+    }
+    catch (const std::exception &e)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_statistics.nbErrors++;
+      }
+      response = ResponseHeader{};
+      response.status = SOLVE_ERROR;
+      return encodeResponse(response, std::vector<double>{}, e.what());
+    }
+  }
+
+  bool SolveDaemon::acquireWorker(double budget, double &waitingTime)
+  { // false if the queue is full or the budget is over before a worker is free
+    Clock::time_point start = Clock::now();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_nbActive >= m_options.nbWorkers)
+    {
+      if (m_nbQueued >= m_options.maxQueued || budget <= 0.0) return false;
+      m_nbQueued++;
+      bool released = m_workerReleased.wait_for(lock, std::chrono::duration<double>(budget), [this]()
+      {
+        return m_nbActive < m_options.nbWorkers || m_stopped;
+      });
+      m_nbQueued--;
+      waitingTime = getSeconds(start);
+      if (!released || m_stopped) return false;
+    }
+    m_nbActive++;
+    return true;
+  }
+
+  void SolveDaemon::releaseWorker()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_nbActive--;
+    }
+    m_workerReleased.notify_one();
+  }
+
+  std::unique_ptr<MILPSolver> SolveDaemon::takeMILPSolver()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_statistics.nbSolversCreated++; // undone below if a warm solver is available
+      if (!m_milpSolvers.empty())
+      {
+        m_statistics.nbSolversCreated--;
+        std::unique_ptr<MILPSolver> solver = std::move(m_milpSolvers.back());
+        m_milpSolvers.pop_back();
+        return solver;
+      }
+    }
+    std::unique_ptr<MILPSolver> solver{new MILPSolver{"daemon", MINIMIZE}};
+    SCIP *scip = solver->getModel();
+    SCIP_CALL_EXC(SCIPsetIntParam(scip, "display/verblevel", 0)); // many models are solved at the same time
+    solver->setLPFastPath(true); // requests are built through the wrapper only
+    solver->setNetworkFastPath(true);
+    if (!m_options.settingsPath.empty()) solver->loadSettings(m_options.settingsPath);
+    includeInterruption(scip, &m_stopped);
+    solver->setCache(m_options.cache);
+    return solver;
+  }
+
+  std::unique_ptr<QUBOSolver> SolveDaemon::takeQUBOSolver(SolverSense sense, double penalty)
+  {
+    std::unique_ptr<QUBOSolver> solver{};
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_quboSolvers.empty())
+      {
+        solver = std::move(m_quboSolvers.back());
+        m_quboSolvers.pop_back();
+      }
+      else m_statistics.nbSolversCreated++;
+    }
+    if (solver != nullptr)
+    {
+      solver->clearModel(sense, penalty);
+      return solver;
+    }
+    solver.reset(new QUBOSolver{sense, penalty});
+    SCIP *scip = solver->getModel();
+    SCIP_CALL_EXC(SCIPsetIntParam(scip, "display/verblevel", 0));
+    if (!m_options.settingsPath.empty()) SCIP_CALL_EXC(SCIPreadParams(scip, m_options.settingsPath.c_str()));
+    includeInterruption(scip, &m_stopped);
+    return solver;
+  }
+
+  void SolveDaemon::returnSolver(std::unique_ptr<MILPSolver> solver)
+  { // cleared right away, thus idle solvers do not keep large models
+    solver->clearModel();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_milpSolvers.push_back(std::move(solver));
+  }
+
+  void SolveDaemon::returnSolver(std::unique_ptr<QUBOSolver> solver)
+  {
+    solver->clearModel(MINIMIZE);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quboSolvers.push_back(std::move(solver));
+  }
+
+  void SolveDaemon::solveMILP(const MILPModel &model, const RequestHeader &header, double timeLimit,
+                              ResponseHeader &response, std::vector<double> &values)
+  { // a solver failing half way is dropped instead of returned, its replacement is created on demand
+    std::unique_ptr<MILPSolver> solver = takeMILPSolver();
+    SCIP *scip = solver->getModel();
+    SCIP_CALL_EXC(SCIPsetObjsense(scip, header.sense == MAXIMIZE ? SCIP_OBJSENSE_MAXIMIZE : SCIP_OBJSENSE_MINIMIZE));
+    SCIP_CALL_EXC(SCIPsetRealParam(scip, "limits/time", std::min(timeLimit, SCIPinfinity(scip))));
+    solver->setNbVars(header.nbVars);
+    solver->setNbCsts(header.nbRows);
+    for (uint64_t i = 0; i < header.nbVars; i++)
+    {
+      solver->createVar(static_cast<VariableType>(model.types[i]), toSCIPBound(scip, model.lowerBounds[i]),
+                        toSCIPBound(scip, model.upperBounds[i]), model.objective[i]);
+    }
+    for (uint64_t r = 0; r < header.nbRows; r++)
+    {
+      fuint32_t row = solver->createLinearConstraint(toSCIPBound(scip, model.lhs[r]), toSCIPBound(scip, model.rhs[r]));
+      for (uint64_t i = model.rowStarts[r]; i < model.rowStarts[r + 1]; i++)
+      {
+        solver->addToCst(row, model.vars[i], model.coefficients[i]);
+      }
+    }
+
+    Clock::time_point start = Clock::now();
+    bool found = solver->solve();
+    response.solvingTime = getSeconds(start);
+    response.nbNodes = solver->getNbNodes();
+    // the solver reports proven results of the fast paths and cache hits as well
+    ResultStatus result = solver->getResultStatus();
+    if (found)
+    {
+      response.status = result == RESULT_OPTIMAL ? SOLVE_OPTIMAL : SOLVE_FEASIBLE;
+      response.objective = SCIPgetSolOrigObj(scip, solver->getSolution());
+      values.resize(header.nbVars);
+      for (fuint32_t i = 0; i < header.nbVars; i++) values[i] = solver->getVariableValue(i);
+    }
+    else response.status = result == RESULT_INFEASIBLE ? SOLVE_INFEASIBLE : SOLVE_NO_SOLUTION;
+    returnSolver(std::move(solver));
+  }
+
+  void SolveDaemon::solveQUBO(const QUBOModel &model, const RequestHeader &header, double timeLimit,
+                              ResponseHeader &response, std::vector<double> &values)
+  {
+    std::unique_ptr<QUBOSolver> solver = takeQUBOSolver(static_cast<SolverSense>(header.sense), header.penalty);
+    SCIP *scip = solver->getModel();
+    SCIP_CALL_EXC(SCIPsetRealParam(scip, "limits/time", std::min(timeLimit, SCIPinfinity(scip))));
+    for (uint64_t i = 0; i < header.nbVars; i++) solver->createBinaryVar();
+    for (uint64_t t = 0; t < header.nbNonzeros; t++)
+    {
+      solver->addQuadraticTerm(model.x[t], model.y[t], model.coefficients[t], model.withPenalty[t] != 0);
+    }
+
+    Clock::time_point start = Clock::now();
+    bool found = solver->solve();
+    response.solvingTime = getSeconds(start);
+    response.nbNodes = SCIPgetStage(scip) >= SCIP_STAGE_TRANSFORMED ? SCIPgetNNodes(scip) : 0;
+    if (found)
+    {
+      response.status = SCIPgetStatus(scip) == SCIP_STATUS_OPTIMAL ? SOLVE_OPTIMAL : SOLVE_FEASIBLE;
+      values.resize(header.nbVars);
+      for (fuint32_t i = 0; i < header.nbVars; i++) values[i] = solver->getBinaryValue(i) ? 1.0 : 0.0;
+      for (uint64_t t = 0; t < header.nbNonzeros; t++)
+      { // the objective without the penalty terms
+        if (model.withPenalty[t] == 0) response.objective += model.coefficients[t] * values[model.x[t]] * values[model.y[t]];
+      }
+    }
+    else response.status = SCIPgetStatus(scip) == SCIP_STATUS_INFEASIBLE ? SOLVE_INFEASIBLE : SOLVE_NO_SOLUTION;
+    returnSolver(std::move(solver));
+  }
+}
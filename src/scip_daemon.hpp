@@ -0,0 +1,100 @@
+#ifndef SCIP_DAEMON_HPP
+#define SCIP_DAEMON_HPP
+
+#include "scip_wrapper.hpp"
+#include "scip_protocol.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*
+ * Long-lived solve server: models arrive over a Unix domain socket (see scip_protocol.hpp for the encoding and
+ * scip_client.hpp for the client) and are solved by a pool of warm MILPSolver/QUBOSolver instances, thus the clients
+ * neither load libscip nor pay for SCIPincludeDefaultPlugins. Every connection is served by its own thread, the number of
+ * concurrent solves is limited by the number of workers and requests waiting beyond the queue limit are rejected.
+ */
+
+namespace scip_wrapper
+{
+  struct DaemonOptions
+  {
+    DaemonOptions(const std::string &_socketPath)
+      : socketPath(_socketPath), nbWorkers(4), maxQueued(16), maxConnections(64), defaultTimeLimit(60.0),
+        maxTimeLimit(3600.0), maxMessageSize(uint64_t{1} << 32), cache(nullptr) {}
+
+    public:
+      std::string socketPath; // replaced if it exists, only accessible by the owner
+      fuint32_t nbWorkers; // concurrent solves, as many MILPSolvers are created on start
+      fuint32_t maxQueued; // requests waiting for a worker
+      fuint32_t maxConnections;
+      double defaultTimeLimit; // seconds, used if a request has none
+      double maxTimeLimit; // requests asking for more are capped
+      uint64_t maxMessageSize; // bytes, larger requests close the connection
+      std::string settingsPath; // SCIP settings loaded into every solver (if not empty)
+      SolutionCache *cache; // shared by all MILPSolvers (if given)
+  };
+
+  struct DaemonStatistics
+  {
+    DaemonStatistics() : nbConnections(0), nbRequests(0), nbRejected(0), nbErrors(0), nbSolversCreated(0) {}
+    void print(std::ostream &os) const;
+
+    public:
+      fuint32_t nbConnections;
+      fuint32_t nbRequests;
+      fuint32_t nbRejected;
+      fuint32_t nbErrors;
+      fuint32_t nbSolversCreated; // warm solvers are reused, failed solvers are replaced
+  };
+
+  class SolveDaemon
+  {
+    public:
+      SolveDaemon(const DaemonOptions &options); // creates the warm MILPSolvers and binds the socket
+      SolveDaemon(const SolveDaemon&) = delete;
+      ~SolveDaemon();
+
+      void run(); // serves until stop() is called
+      void stop(); // async-signal-safe, thus also callable from a signal handler
+      DaemonStatistics getStatistics();
+
+    private:
+      struct MILPModel;
+      struct QUBOModel;
+
+    private:
+      void serve(int fd);
+      std::vector<char> handle(const std::vector<char> &request);
+      bool acquireWorker(double budget, double &waitingTime);
+      void releaseWorker();
+      void solveMILP(const MILPModel &model, const RequestHeader &header, double timeLimit, ResponseHeader &response,
+                     std::vector<double> &values);
+      void solveQUBO(const QUBOModel &model, const RequestHeader &header, double timeLimit, ResponseHeader &response,
+                     std::vector<double> &values);
+      std::unique_ptr<MILPSolver> takeMILPSolver();
+      std::unique_ptr<QUBOSolver> takeQUBOSolver(SolverSense sense, double penalty);
+      void returnSolver(std::unique_ptr<MILPSolver> solver);
+      void returnSolver(std::unique_ptr<QUBOSolver> solver);
+      void joinFinished();
+
+    private:
+      DaemonOptions m_options;
+      int m_listenFd;
+      int m_stopPipe[2]; // written by stop(), wakes up the accept loop
+      std::atomic<bool> m_stopped; // also interrupts running solves
+
+      std::mutex m_mutex;
+      std::condition_variable m_workerReleased;
+      fuint32_t m_nbActive;
+      fuint32_t m_nbQueued;
+      std::vector<std::unique_ptr<MILPSolver>> m_milpSolvers; // idle warm solvers
+      std::vector<std::unique_ptr<QUBOSolver>> m_quboSolvers;
+      std::map<int, std::thread> m_connections; // by socket
+      std::vector<int> m_finished; // connections whose threads can be joined
+      DaemonStatistics m_statistics;
+  };
+}
+
+#endif
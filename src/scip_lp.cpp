@@ -0,0 +1,99 @@
+#include "scip_lp.hpp"
+
+#include <lpi/lpi.h>
+
+using namespace scip_wrapper;
+
+namespace
+{
+  double toLPInfinity(SCIP *scip, SCIP_LPI *lpi, double value)
+  {
+    if (SCIPisInfinity(scip, value)) return SCIPlpiInfinity(lpi);
+    if (SCIPisInfinity(scip, -value)) return -SCIPlpiInfinity(lpi);
+    return value;
+  }
+
+  struct LPRows
+  { // compressed sparse rows as expected by SCIPlpiAddRows
+    void addRow(const LinearRow &row, fuint32_t nbVariables)
+    {
+      if (row.vars.size() != row.coefficients.size()) throw std::invalid_argument("Amount of variables and coefficients differs...");
+      std::vector<std::pair<fuint32_t, double>> entries{};
+      for (fuint32_t i = 0; i < row.vars.size(); i++)
+      {
+        if (row.vars[i] >= nbVariables) throw std::range_error("Out of range in adding to constraint...");
+        entries.push_back(std::make_pair(row.vars[i], row.coefficients[i]));
+      }
+      std::sort(entries.begin(), entries.end());
+      for (fuint32_t i = 0; i < entries.size(); i++)
+      {
+        if (i > 0 && entries[i].first == entries[i - 1].first) values.back() += entries[i].second;
+        else
+        {
+          indices.push_back(entries[i].first);
+          values.push_back(entries[i].second);
+        }
+      }
+      starts.push_back(indices.size());
+    }
+
+    public:
+      std::vector<int> starts{0};
+      std::vector<int> indices;
+      std::vector<double> values;
+  };
+}
+
+namespace scip_wrapper
+{
+  bool solveLP(SCIP *scip, const std::vector<SCIPVariable> &variables, const std::vector<LinearRow> &rows, LPSolution &solution)
+  {
+    SCIP_LPI *lpi = nullptr;
+    // the LP interface has its own sense type (SCIP_OBJSEN instead of SCIP_OBJSENSE)
+    SCIP_OBJSEN sense = SCIPgetObjsense(scip) == SCIP_OBJSENSE_MAXIMIZE ? SCIP_OBJSEN_MAXIMIZE : SCIP_OBJSEN_MINIMIZE;
+    SCIP_CALL_EXC(SCIPlpiCreate(&lpi, SCIPgetMessagehdlr(scip), "relaxation", sense));
+    bool optimal = false;
+    try
+    {
+      std::vector<double> objective{}, lb{}, ub{};
+      for (const auto &var : variables)
+      {
+        objective.push_back(SCIPvarGetObj(var.variable));
+        lb.push_back(toLPInfinity(scip, lpi, SCIPvarGetLbOriginal(var.variable)));
+        ub.push_back(toLPInfinity(scip, lpi, SCIPvarGetUbOriginal(var.variable)));
+      }
+      SCIP_CALL_EXC(SCIPlpiAddCols(lpi, variables.size(), objective.data(), lb.data(), ub.data(), NULL, 0, NULL, NULL, NULL));
+
+      LPRows lpRows{};
+      std::vector<double> lhs{}, rhs{};
+      for (const auto &row : rows)
+      {
+        lpRows.addRow(row, variables.size());
+        lhs.push_back(toLPInfinity(scip, lpi, row.lhs));
+        rhs.push_back(toLPInfinity(scip, lpi, row.rhs));
+      }
+      SCIP_CALL_EXC(SCIPlpiAddRows(lpi, rows.size(), lhs.data(), rhs.data(), NULL, lpRows.indices.size(),
+                                   lpRows.starts.data(), lpRows.indices.data(), lpRows.values.data()));
+
+      SCIP_CALL_EXC(SCIPlpiSolveDual(lpi));
+      SCIP_CALL_EXC(SCIPlpiGetIterations(lpi, &solution.nbIterations));
+      optimal = SCIPlpiIsOptimal(lpi);
+      solution.infeasible = !optimal && SCIPlpiIsPrimalInfeasible(lpi);
+      if (optimal)
+      {
+        solution.values.resize(variables.size());
+        solution.reducedCosts.resize(variables.size());
+        solution.duals.resize(rows.size());
+        SCIP_CALL_EXC(SCIPlpiGetSol(lpi, &solution.objective, solution.values.data(), solution.duals.data(),
+                                    NULL, solution.reducedCosts.data()));
+      }
+    }
+    catch (...)
+    {
+      SCIPlpiFree(&lpi);
+      throw;
+    }
+    SCIP_CALL_EXC(SCIPlpiFree(&lpi));
+    return optimal;
+  }
+}
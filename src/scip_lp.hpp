@@ -0,0 +1,17 @@
+#ifndef SCIP_LP_HPP
+#define SCIP_LP_HPP
+
+#include "scip_wrapper.hpp"
+
+/*
+ * Solves the linear part of a MILPSolver's model using SCIP's LP interface directly (no presolving, no tree).
+ * Only used internally by the MILPSolver.
+ */
+
+namespace scip_wrapper
+{
+  // variables are continuous with their original bounds and objective, rows with duplicate variables are merged
+  bool solveLP(SCIP *scip, const std::vector<SCIPVariable> &variables, const std::vector<LinearRow> &rows, LPSolution &solution);
+}
+
+#endif
@@ -0,0 +1,471 @@
+#include "scip_network.hpp"
+
+using namespace scip_wrapper;
+
+#define STATE_UPPER -1
+#define STATE_TREE 0
+#define STATE_LOWER 1
+#define DIR_UP 1
+#define DIR_DOWN -1
+#define BLOCK_SIZE_FACTOR 1.0
+#define MIN_BLOCK_SIZE 10
+#define COST_EPSILON 1e-9 // reduced costs above -COST_EPSILON are considered optimal
+#define FLOW_EPSILON 1e-9
+
+namespace scip_wrapper
+{
+  NetworkSimplex::NetworkSimplex(fuint32_t nbNodes)
+    : m_supplies(nbNodes, 0.0), m_potentials(nbNodes, 0.0), m_nbPivots(0), m_nbNodes(0), m_nbArcs(0), m_root(0),
+      m_blockSize(0), m_nextArc(0), m_inArc(0), m_join(0), m_uIn(0), m_vIn(0), m_uOut(0), m_vOut(0), m_delta(0.0)
+  {
+    if (nbNodes >= static_cast<fuint32_t>(std::numeric_limits<int>::max())) throw std::range_error("Too many nodes...");
+  }
+
+  fuint32_t NetworkSimplex::addArc(fuint32_t from, fuint32_t to, double lowerBound, double upperBound, double cost)
+  {
+    if (from >= m_supplies.size() || to >= m_supplies.size()) throw std::range_error("Node index out of bounds...");
+    if (!std::isfinite(lowerBound) || upperBound < lowerBound) throw std::invalid_argument("Invalid arc bounds...");
+    if (!std::isfinite(cost)) throw std::invalid_argument("Arc costs have to be finite...");
+    m_arcSources.push_back(from);
+    m_arcTargets.push_back(to);
+    m_arcLower.push_back(lowerBound);
+    m_arcUpper.push_back(upperBound);
+    m_arcCosts.push_back(cost);
+    m_flows.push_back(0.0);
+    return m_arcCosts.size() - 1;
+  }
+
+  void NetworkSimplex::setSupply(fuint32_t node, double supply)
+  {
+    if (node >= m_supplies.size()) throw std::range_error("Node index out of bounds...");
+    if (!std::isfinite(supply)) throw std::invalid_argument("Supplies have to be finite...");
+    m_supplies[node] = supply;
+  }
+
+  double NetworkSimplex::getTotalCost() const
+  {
+    double cost = 0.0;
+    for (fuint32_t e = 0; e < m_arcCosts.size(); e++) cost += m_arcCosts[e] * m_flows[e];
+    return cost;
+  }
+
+  void NetworkSimplex::init()
+  {
+    m_nbNodes = m_supplies.size();
+    m_nbArcs = m_arcCosts.size();
+    m_root = m_nbNodes;
+    int nbAllArcs = m_nbArcs + m_nbNodes;
+    int nbAllNodes = m_nbNodes + 1;
+
+    // counting sort of the arcs by source, the block search then scans the arcs node by node
+    std::vector<int> starts(nbAllNodes, 0);
+    for (int e = 0; e < m_nbArcs; e++) starts[m_arcSources[e] + 1]++;
+    for (int u = 0; u < m_nbNodes; u++) starts[u + 1] += starts[u];
+    m_order.assign(m_nbArcs, 0);
+    for (int e = 0; e < m_nbArcs; e++) m_order[starts[m_arcSources[e]]++] = e;
+
+    m_source.assign(nbAllArcs, 0);
+    m_target.assign(nbAllArcs, 0);
+    m_cap.assign(nbAllArcs, 0.0);
+    m_cost.assign(nbAllArcs, 0.0);
+    m_flow.assign(nbAllArcs, 0.0);
+    m_state.assign(nbAllArcs, STATE_LOWER);
+    m_supply.assign(nbAllNodes, 0.0);
+    m_pi.assign(nbAllNodes, 0.0);
+    m_parent.assign(nbAllNodes, 0);
+    m_pred.assign(nbAllNodes, 0);
+    m_thread.assign(nbAllNodes, 0);
+    m_revThread.assign(nbAllNodes, 0);
+    m_succNum.assign(nbAllNodes, 0);
+    m_lastSucc.assign(nbAllNodes, 0);
+    m_predDir.assign(nbAllNodes, DIR_UP);
+
+    // lower bounds are shifted into the supplies
+    for (int u = 0; u < m_nbNodes; u++) m_supply[u] = m_supplies[u];
+    double maxCost = 0.0;
+    for (int e = 0; e < m_nbArcs; e++)
+    {
+      int arc = m_order[e];
+      m_source[e] = m_arcSources[arc];
+      m_target[e] = m_arcTargets[arc];
+      m_cap[e] = m_arcUpper[arc] - m_arcLower[arc];
+      m_cost[e] = m_arcCosts[arc];
+      m_supply[m_source[e]] -= m_arcLower[arc];
+      m_supply[m_target[e]] += m_arcLower[arc];
+      maxCost = std::max(maxCost, m_cost[e]);
+    }
+    double artificialCost = (maxCost + 1.0) * m_nbNodes;
+
+    // initial tree: every node is attached to the root by an artificial arc carrying its supply
+    m_parent[m_root] = -1;
+    m_pred[m_root] = -1;
+    m_thread[m_root] = 0;
+    m_revThread[0] = m_root;
+    m_succNum[m_root] = nbAllNodes;
+    m_lastSucc[m_root] = m_root - 1;
+    m_pi[m_root] = 0.0;
+    for (int u = 0; u < m_nbNodes; u++)
+    {
+      int e = m_nbArcs + u;
+      m_parent[u] = m_root;
+      m_pred[u] = e;
+      m_thread[u] = u + 1;
+      m_revThread[u + 1] = u;
+      m_succNum[u] = 1;
+      m_lastSucc[u] = u;
+      m_cap[e] = std::numeric_limits<double>::infinity();
+      m_state[e] = STATE_TREE;
+      if (m_supply[u] >= 0.0)
+      {
+        m_predDir[u] = DIR_UP;
+        m_pi[u] = 0.0;
+        m_source[e] = u;
+        m_target[e] = m_root;
+        m_flow[e] = m_supply[u];
+        m_cost[e] = 0.0;
+      }
+      else
+      {
+        m_predDir[u] = DIR_DOWN;
+        m_pi[u] = artificialCost;
+        m_source[e] = m_root;
+        m_target[e] = u;
+        m_flow[e] = -m_supply[u];
+        m_cost[e] = artificialCost;
+      }
+    }
+
+    m_blockSize = std::max(static_cast<int>(std::ceil(BLOCK_SIZE_FACTOR * std::sqrt(static_cast<double>(m_nbArcs)))),
+                           MIN_BLOCK_SIZE);
+    m_nextArc = 0;
+    m_nbPivots = 0;
+  }
+
+  bool NetworkSimplex::findEnteringArc()
+  { // block search: the most violating arc of the first block containing a violating arc
+    if (m_nbArcs == 0) return false;
+    double minimum = -COST_EPSILON;
+    int count = m_blockSize;
+    int e = m_nextArc;
+    bool found = false;
+    for (int i = 0; i < m_nbArcs; i++)
+    {
+      double c = m_state[e] * (m_cost[e] + m_pi[m_source[e]] - m_pi[m_target[e]]);
+      if (c < minimum)
+      {
+        minimum = c;
+        m_inArc = e;
+        found = true;
+      }
+      if (++e == m_nbArcs) e = 0;
+      if (--count == 0)
+      {
+        if (found) break;
+        count = m_blockSize;
+      }
+    }
+    m_nextArc = e;
+    return found;
+  }
+
+  void NetworkSimplex::findJoinNode()
+  {
+    int u = m_source[m_inArc];
+    int v = m_target[m_inArc];
+    while (u != v)
+    {
+      if (m_succNum[u] < m_succNum[v]) u = m_parent[u];
+      else v = m_parent[v];
+    }
+    m_join = u;
+  }
+
+  bool NetworkSimplex::findLeavingArc()
+  { // ties are broken towards the end of the cycle, which keeps the tree strongly feasible
+    int first, second;
+    if (m_state[m_inArc] == STATE_LOWER)
+    {
+      first = m_source[m_inArc];
+      second = m_target[m_inArc];
+    }
+    else
+    {
+      first = m_target[m_inArc];
+      second = m_source[m_inArc];
+    }
+    m_delta = m_cap[m_inArc];
+    int result = 0;
+    for (int u = first; u != m_join; u = m_parent[u])
+    {
+      int e = m_pred[u];
+      double d = m_predDir[u] == DIR_DOWN ? m_cap[e] - m_flow[e] : m_flow[e];
+      if (d < m_delta)
+      {
+        m_delta = d;
+        m_uOut = u;
+        result = 1;
+      }
+    }
+    for (int u = second; u != m_join; u = m_parent[u])
+    {
+      int e = m_pred[u];
+      double d = m_predDir[u] == DIR_UP ? m_cap[e] - m_flow[e] : m_flow[e];
+      if (d <= m_delta)
+      {
+        m_delta = d;
+        m_uOut = u;
+        result = 2;
+      }
+    }
+    if (result == 1)
+    {
+      m_uIn = first;
+      m_vIn = second;
+    }
+    else
+    {
+      m_uIn = second;
+      m_vIn = first;
+    }
+    return result != 0;
+  }
+
+  void NetworkSimplex::changeFlow(bool change)
+  {
+    if (m_delta > 0.0)
+    {
+      double value = m_state[m_inArc] * m_delta;
+      m_flow[m_inArc] += value;
+      for (int u = m_source[m_inArc]; u != m_join; u = m_parent[u]) m_flow[m_pred[u]] -= m_predDir[u] * value;
+      for (int u = m_target[m_inArc]; u != m_join; u = m_parent[u]) m_flow[m_pred[u]] += m_predDir[u] * value;
+    }
+    if (change)
+    {
+      m_state[m_inArc] = STATE_TREE;
+      int e = m_pred[m_uOut];
+      if (m_flow[e] <= m_cap[e] - m_flow[e])
+      {
+        m_state[e] = STATE_LOWER;
+        m_flow[e] = 0.0;
+      }
+      else
+      { // rounding errors are not accumulated on arcs leaving the tree
+        m_state[e] = STATE_UPPER;
+        m_flow[e] = m_cap[e];
+      }
+    }
+    else
+    {
+      m_state[m_inArc] = -m_state[m_inArc];
+      m_flow[m_inArc] = m_state[m_inArc] == STATE_UPPER ? m_cap[m_inArc] : 0.0;
+    }
+  }
+
+  void NetworkSimplex::updateTreeStructure()
+  {
+    int oldRevThread = m_revThread[m_uOut];
+    int oldSuccNum = m_succNum[m_uOut];
+    int oldLastSucc = m_lastSucc[m_uOut];
+    m_vOut = m_parent[m_uOut];
+
+    if (m_uIn == m_uOut)
+    { // only the subtree of u_out is moved below v_in
+      m_parent[m_uIn] = m_vIn;
+      m_pred[m_uIn] = m_inArc;
+      m_predDir[m_uIn] = m_uIn == m_source[m_inArc] ? DIR_UP : DIR_DOWN;
+      if (m_thread[m_vIn] != m_uOut)
+      {
+        int after = m_thread[oldLastSucc];
+        m_thread[oldRevThread] = after;
+        m_revThread[after] = oldRevThread;
+        after = m_thread[m_vIn];
+        m_thread[m_vIn] = m_uOut;
+        m_revThread[m_uOut] = m_vIn;
+        m_thread[oldLastSucc] = after;
+        m_revThread[after] = oldLastSucc;
+      }
+    }
+    else
+    { // the stem from u_in to u_out is reversed
+      int threadContinue = oldRevThread == m_vIn ? m_thread[oldLastSucc] : m_thread[m_vIn];
+      int stem = m_uIn;
+      int parentStem = m_vIn;
+      int last = m_lastSucc[m_uIn];
+      int after = m_thread[last];
+      m_thread[m_vIn] = m_uIn;
+      m_dirtyRevs.clear();
+      m_dirtyRevs.push_back(m_vIn);
+      while (stem != m_uOut)
+      {
+        int nextStem = m_parent[stem];
+        m_thread[last] = nextStem;
+        m_dirtyRevs.push_back(last);
+
+        int before = m_revThread[stem];
+        m_thread[before] = after;
+        m_revThread[after] = before;
+
+        m_parent[stem] = parentStem;
+        parentStem = stem;
+        stem = nextStem;
+
+        last = m_lastSucc[stem] == m_lastSucc[parentStem] ? m_revThread[parentStem] : m_lastSucc[stem];
+        after = m_thread[last];
+      }
+      m_parent[m_uOut] = parentStem;
+      m_thread[last] = threadContinue;
+      m_revThread[threadContinue] = last;
+      m_lastSucc[m_uOut] = last;
+
+      if (oldRevThread != m_vIn)
+      {
+        m_thread[oldRevThread] = after;
+        m_revThread[after] = oldRevThread;
+      }
+      for (int u : m_dirtyRevs) m_revThread[m_thread[u]] = u;
+
+      int succNum = 0;
+      int lastSucc = m_lastSucc[m_uOut];
+      for (int u = m_uOut, p = m_parent[u]; u != m_uIn; u = p, p = m_parent[u])
+      {
+        m_pred[u] = m_pred[p];
+        m_predDir[u] = -m_predDir[p];
+        succNum += m_succNum[u] - m_succNum[p];
+        m_succNum[u] = succNum;
+        m_lastSucc[p] = lastSucc;
+      }
+      m_pred[m_uIn] = m_inArc;
+      m_predDir[m_uIn] = m_uIn == m_source[m_inArc] ? DIR_UP : DIR_DOWN;
+      m_succNum[m_uIn] = oldSuccNum;
+    }
+
+    // last successors and subtree sizes on the paths towards the join node
+    int upLimitOut = m_lastSucc[m_join] == m_vIn ? m_join : -1;
+    int lastSuccOut = m_lastSucc[m_uOut];
+    for (int u = m_vIn; u != -1 && m_lastSucc[u] == m_vIn; u = m_parent[u]) m_lastSucc[u] = lastSuccOut;
+    if (m_join != oldRevThread && m_vIn != oldRevThread)
+    {
+      for (int u = m_vOut; u != upLimitOut && m_lastSucc[u] == oldLastSucc; u = m_parent[u]) m_lastSucc[u] = oldRevThread;
+    }
+    else if (lastSuccOut != oldLastSucc)
+    {
+      for (int u = m_vOut; u != upLimitOut && m_lastSucc[u] == oldLastSucc; u = m_parent[u]) m_lastSucc[u] = lastSuccOut;
+    }
+    for (int u = m_vIn; u != m_join; u = m_parent[u]) m_succNum[u] += oldSuccNum;
+    for (int u = m_vOut; u != m_join; u = m_parent[u]) m_succNum[u] -= oldSuccNum;
+  }
+
+  void NetworkSimplex::updatePotential()
+  { // the subtree of u_in is shifted such that the entering arc has zero reduced cost
+    double sigma = m_pi[m_vIn] - m_pi[m_uIn] - m_predDir[m_uIn] * m_cost[m_inArc];
+    int end = m_thread[m_lastSucc[m_uIn]];
+    for (int u = m_uIn; u != end; u = m_thread[u]) m_pi[u] += sigma;
+  }
+
+  NetworkStatus NetworkSimplex::solve()
+  {
+    init();
+    while (findEnteringArc())
+    {
+      findJoinNode();
+      bool change = findLeavingArc();
+      if (m_delta == std::numeric_limits<double>::infinity()) return NETWORK_UNBOUNDED;
+      changeFlow(change);
+      if (change)
+      {
+        updateTreeStructure();
+        updatePotential();
+      }
+      m_nbPivots++;
+    }
+
+    double scale = 1.0;
+    for (int u = 0; u < m_nbNodes; u++) scale = std::max(scale, std::abs(m_supply[u]));
+    for (int e = m_nbArcs; e < m_nbArcs + m_nbNodes; e++)
+    { // flow remaining on an artificial arc cannot be routed through the network
+      if (m_flow[e] > FLOW_EPSILON * scale) return NETWORK_INFEASIBLE;
+    }
+    for (int e = 0; e < m_nbArcs; e++) m_flows[m_order[e]] = m_flow[e] + m_arcLower[m_order[e]];
+    for (int u = 0; u < m_nbNodes; u++) m_potentials[u] = m_pi[u];
+    return NETWORK_OPTIMAL;
+  }
+}
+
+namespace
+{
+  const fuint32_t NO_ROW = std::numeric_limits<fuint32_t>::max();
+
+  bool isIntegral(double value)
+  {
+    return value == std::floor(value);
+  }
+
+  double toNetworkBound(SCIP *scip, double value)
+  {
+    if (SCIPisInfinity(scip, value)) return std::numeric_limits<double>::infinity();
+    if (SCIPisInfinity(scip, -value)) return -std::numeric_limits<double>::infinity();
+    return value;
+  }
+}
+
+namespace scip_wrapper
+{
+  std::unique_ptr<NetworkSimplex> createNetwork(SCIP *scip, const std::vector<SCIPVariable> &variables,
+                                                const std::vector<LinearRow> &rows)
+  {
+    bool needsIntegrality = false;
+    for (const auto &var : variables)
+    {
+      if (SCIPvarGetType(var.variable) != SCIP_VARTYPE_CONTINUOUS) needsIntegrality = true;
+    }
+
+    // tail (-1 entry) and head (+1 entry) of every column
+    std::vector<fuint32_t> tails(variables.size(), NO_ROW), heads(variables.size(), NO_ROW);
+    for (fuint32_t r = 0; r < rows.size(); r++)
+    {
+      const LinearRow &row = rows[r];
+      if (row.lhs != row.rhs || SCIPisInfinity(scip, std::abs(row.rhs))) return nullptr;
+      if (needsIntegrality && !isIntegral(row.rhs)) return nullptr;
+      if (row.vars.size() != row.coefficients.size()) throw std::invalid_argument("Amount of variables and coefficients differs...");
+      for (fuint32_t i = 0; i < row.vars.size(); i++)
+      {
+        fuint32_t var = row.vars[i];
+        if (var >= variables.size()) throw std::range_error("Out of range in adding to constraint...");
+        std::vector<fuint32_t> &ends = row.coefficients[i] == 1.0 ? heads : tails;
+        if ((row.coefficients[i] != 1.0 && row.coefficients[i] != -1.0) || ends[var] != NO_ROW) return nullptr;
+        ends[var] = r;
+      }
+    }
+
+    double sign = SCIPgetObjsense(scip) == SCIP_OBJSENSE_MAXIMIZE ? -1.0 : 1.0;
+    std::unique_ptr<NetworkSimplex> network{new NetworkSimplex{static_cast<fuint32_t>(rows.size())}};
+    for (fuint32_t i = 0; i < variables.size(); i++)
+    {
+      if (tails[i] == NO_ROW || heads[i] == NO_ROW) return nullptr;
+      double lb = toNetworkBound(scip, SCIPvarGetLbOriginal(variables[i].variable));
+      double ub = toNetworkBound(scip, SCIPvarGetUbOriginal(variables[i].variable));
+      if (!std::isfinite(lb) || ub < lb) return nullptr;
+      if (needsIntegrality && (!isIntegral(lb) || (std::isfinite(ub) && !isIntegral(ub)))) return nullptr;
+      network->addArc(tails[i], heads[i], lb, ub, sign * SCIPvarGetObj(variables[i].variable));
+    }
+    for (fuint32_t r = 0; r < rows.size(); r++) network->setSupply(r, -rows[r].rhs); // rows are inflow - outflow = rhs
+    return network;
+  }
+
+  void getNetworkSolution(SCIP *scip, const NetworkSimplex &network, LPSolution &solution)
+  { // potentials are the duals of the minimization problem, reduced costs are cost + potential(tail) - potential(head)
+    double sign = SCIPgetObjsense(scip) == SCIP_OBJSENSE_MAXIMIZE ? -1.0 : 1.0;
+    solution.nbIterations = network.getNbPivots();
+    solution.objective = sign * network.getTotalCost();
+    solution.values.resize(network.getNbArcs());
+    solution.reducedCosts.resize(network.getNbArcs());
+    solution.duals.resize(network.getNbNodes());
+    for (fuint32_t node = 0; node < network.getNbNodes(); node++) solution.duals[node] = sign * network.getPotential(node);
+    for (fuint32_t arc = 0; arc < network.getNbArcs(); arc++)
+    {
+      solution.values[arc] = network.getFlow(arc);
+      solution.reducedCosts[arc] = sign * (network.getArcCost(arc) + network.getPotential(network.getArcSource(arc))
+                                           - network.getPotential(network.getArcTarget(arc)));
+    }
+  }
+}
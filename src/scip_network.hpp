@@ -0,0 +1,108 @@
+#ifndef SCIP_NETWORK_HPP
+#define SCIP_NETWORK_HPP
+
+#include "scip_wrapper.hpp"
+
+/*
+ * Primal network simplex for min-cost flow problems (following the implementation of LEMON):
+ * a strongly feasible spanning tree stored by parents and a thread list, the entering arc is
+ * chosen by block search. Arcs are kept sorted by their source node (compressed sparse rows).
+ * Usable on its own, the MILPSolver also routes pure network flow models to it.
+ */
+
+namespace scip_wrapper
+{
+  enum NetworkStatus
+  {
+    NETWORK_OPTIMAL,
+    NETWORK_INFEASIBLE,
+    NETWORK_UNBOUNDED
+  };
+
+  class NetworkSimplex
+  {
+    public:
+      NetworkSimplex(fuint32_t nbNodes);
+
+    public:
+      // flow on the arc lies in [lowerBound, upperBound], upperBound may be infinite
+      fuint32_t addArc(fuint32_t from, fuint32_t to, double lowerBound, double upperBound, double cost);
+      void setSupply(fuint32_t node, double supply); // outflow - inflow of the node, negative for demands
+      NetworkStatus solve();
+
+      double getFlow(fuint32_t arc) const { return m_flows.at(arc); }
+      // potentials of an optimal solution, the reduced cost of an arc (u,v) is cost + potential(u) - potential(v)
+      double getPotential(fuint32_t node) const { return m_potentials.at(node); }
+      double getTotalCost() const;
+      fuint32_t getNbNodes() const { return m_supplies.size(); }
+      fuint32_t getNbArcs() const { return m_arcCosts.size(); }
+      fuint32_t getArcSource(fuint32_t arc) const { return m_arcSources.at(arc); }
+      fuint32_t getArcTarget(fuint32_t arc) const { return m_arcTargets.at(arc); }
+      double getArcCost(fuint32_t arc) const { return m_arcCosts.at(arc); }
+      fuint32_t getNbPivots() const { return m_nbPivots; }
+
+    private:
+      void init();
+      bool findEnteringArc();
+      void findJoinNode();
+      bool findLeavingArc();
+      void changeFlow(bool change);
+      void updateTreeStructure();
+      void updatePotential();
+
+    private:
+      // the problem as added (arcs in the order of addArc)
+      std::vector<fuint32_t> m_arcSources;
+      std::vector<fuint32_t> m_arcTargets;
+      std::vector<double> m_arcLower;
+      std::vector<double> m_arcUpper;
+      std::vector<double> m_arcCosts;
+      std::vector<double> m_supplies;
+      std::vector<double> m_flows;
+      std::vector<double> m_potentials;
+      fuint32_t m_nbPivots;
+
+      // working arrays, arcs sorted by source followed by one artificial arc per node, the root is node n
+      int m_nbNodes;
+      int m_nbArcs;
+      int m_root;
+      std::vector<int> m_order; // m_order[e] is the arc as added of the sorted arc e
+      std::vector<int> m_source;
+      std::vector<int> m_target;
+      std::vector<double> m_cap;
+      std::vector<double> m_cost;
+      std::vector<double> m_supply;
+      std::vector<double> m_flow;
+      std::vector<double> m_pi;
+      std::vector<int> m_parent;
+      std::vector<int> m_pred;
+      std::vector<int> m_thread;
+      std::vector<int> m_revThread;
+      std::vector<int> m_succNum;
+      std::vector<int> m_lastSucc;
+      std::vector<int> m_predDir;
+      std::vector<int> m_state;
+      std::vector<int> m_dirtyRevs;
+
+      // pivot data
+      int m_blockSize;
+      int m_nextArc;
+      int m_inArc;
+      int m_join;
+      int m_uIn;
+      int m_vIn;
+      int m_uOut;
+      int m_vOut;
+      double m_delta;
+  };
+
+  // the network of a model whose rows are equalities and whose columns have exactly one +1 and one -1 entry (nodes
+  // are the rows, arc i is variable i, flowing from its -1 row to its +1 row). Integer variables are allowed if all
+  // bounds and right hand sides are integral (the flows are integral then). Returns nullptr for other models.
+  std::unique_ptr<NetworkSimplex> createNetwork(SCIP *scip, const std::vector<SCIPVariable> &variables,
+                                                const std::vector<LinearRow> &rows);
+  // flows, duals (potentials) and reduced costs in the sense of the model
+  void getNetworkSolution(SCIP *scip, const NetworkSimplex &network, LPSolution &solution);
+}
+
+#endif
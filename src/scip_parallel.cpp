@@ -0,0 +1,264 @@
+#include "scip_parallel.hpp"
+
+#include <thread>
+
+using namespace scip_wrapper;
+
+#define EVENTHDLR_NAME "shared_incumbent"
+#define INTERRUPT_EVENTHDLR_NAME "portfolio_interrupt"
+
+namespace
+{
+  std::mutex copyMutex;
+
+  struct ParamValue
+  {
+    SCIP_PARAM *param;
+    SCIP_Bool boolValue;
+    int intValue;
+    SCIP_Longint longintValue;
+    SCIP_Real realValue;
+    char charValue;
+    std::string stringValue;
+  };
+
+  std::vector<ParamValue> getChangedParams(SCIP *scip)
+  { // parameters differing from their defaults, e.g. copied from the source model or set by the user
+    std::vector<ParamValue> changed{};
+    SCIP_PARAM **params = SCIPgetParams(scip);
+    for (int i = 0; i < SCIPgetNParams(scip); i++)
+    {
+      if (SCIPparamIsDefault(params[i])) continue;
+      ParamValue value{params[i], FALSE, 0, 0, 0.0, '\0', ""};
+      switch (SCIPparamGetType(params[i]))
+      {
+        case SCIP_PARAMTYPE_BOOL: value.boolValue = SCIPparamGetBool(params[i]); break;
+        case SCIP_PARAMTYPE_INT: value.intValue = SCIPparamGetInt(params[i]); break;
+        case SCIP_PARAMTYPE_LONGINT: value.longintValue = SCIPparamGetLongint(params[i]); break;
+        case SCIP_PARAMTYPE_REAL: value.realValue = SCIPparamGetReal(params[i]); break;
+        case SCIP_PARAMTYPE_CHAR: value.charValue = SCIPparamGetChar(params[i]); break;
+        case SCIP_PARAMTYPE_STRING: value.stringValue = SCIPparamGetString(params[i]); break;
+      }
+      changed.push_back(value);
+    }
+    return changed;
+  }
+
+  void restoreParams(SCIP *scip, const std::vector<ParamValue> &values)
+  {
+    for (const auto &value : values)
+    {
+      switch (SCIPparamGetType(value.param))
+      {
+        case SCIP_PARAMTYPE_BOOL: SCIP_CALL_EXC(SCIPchgBoolParam(scip, value.param, value.boolValue)); break;
+        case SCIP_PARAMTYPE_INT: SCIP_CALL_EXC(SCIPchgIntParam(scip, value.param, value.intValue)); break;
+        case SCIP_PARAMTYPE_LONGINT: SCIP_CALL_EXC(SCIPchgLongintParam(scip, value.param, value.longintValue)); break;
+        case SCIP_PARAMTYPE_REAL: SCIP_CALL_EXC(SCIPchgRealParam(scip, value.param, value.realValue)); break;
+        case SCIP_PARAMTYPE_CHAR: SCIP_CALL_EXC(SCIPchgCharParam(scip, value.param, value.charValue)); break;
+        case SCIP_PARAMTYPE_STRING: SCIP_CALL_EXC(SCIPchgStringParam(scip, value.param, value.stringValue.c_str())); break;
+      }
+    }
+  }
+}
+
+static SCIP_DECL_EVENTINIT(incumbentInit)
+{
+  SCIP_CALL(SCIPcatchEvent(scip, SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, NULL));
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXEC(incumbentExec)
+{
+  auto *incumbent = reinterpret_cast<SharedIncumbent*>(SCIPeventhdlrGetData(eventhdlr));
+  if ((SCIPeventGetType(event) & SCIP_EVENTTYPE_BESTSOLFOUND) != 0)
+  {
+    incumbent->update(SCIPgetSolOrigObj(scip, SCIPgetBestSol(scip)));
+  }
+  double objective = incumbent->get();
+  if (incumbent->isBetter(objective, SCIPgetObjlimit(scip)))
+  { // subtrees not beating the incumbent of another copy are cut off
+    SCIP_CALL(SCIPsetObjlimit(scip, objective));
+  }
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTINIT(interruptInit)
+{
+  SCIP_CALL(SCIPcatchEvent(scip, SCIP_EVENTTYPE_LPSOLVED | SCIP_EVENTTYPE_NODESOLVED, eventhdlr, NULL, NULL));
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXEC(interruptExec)
+{ // SCIPinterruptSolve is called by the solving thread itself, the other threads only set the flag
+  auto *stop = reinterpret_cast<std::atomic<bool>*>(SCIPeventhdlrGetData(eventhdlr));
+  if (stop->load() && !SCIPisStopped(scip))
+  {
+    SCIP_CALL(SCIPinterruptSolve(scip));
+  }
+  return SCIP_OKAY;
+}
+
+namespace scip_wrapper
+{
+  bool SharedIncumbent::update(double value)
+  {
+    double current = objective.load();
+    while (isBetter(value, current))
+    {
+      if (objective.compare_exchange_weak(current, value)) return true;
+    }
+    return false;
+  }
+
+  ModelCopy::~ModelCopy()
+  {
+    if (scip == nullptr) return;
+    if (SCIPfree(&scip) != SCIP_OKAY) std::cerr << "Error while trying to free a copy of the model..." << std::endl;
+  }
+
+  WorkStealingPool::WorkStealingPool(fuint32_t nbWorkers)
+    : m_queues(nbWorkers)
+  {
+    if (nbWorkers == 0) throw std::invalid_argument("At least one worker is needed...");
+    for (fuint32_t i = 0; i < nbWorkers; i++) m_mutexes.emplace_back(new std::mutex{});
+  }
+
+  bool WorkStealingPool::nextTask(fuint32_t worker, fuint32_t &task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(*m_mutexes[worker]);
+      if (!m_queues[worker].empty())
+      {
+        task = m_queues[worker].front();
+        m_queues[worker].pop_front();
+        return true;
+      }
+    }
+    for (fuint32_t offset = 1; offset < m_queues.size(); offset++)
+    { // no tasks are added while running, thus one pass over the other queues suffices
+      fuint32_t victim = (worker + offset) % m_queues.size();
+      std::lock_guard<std::mutex> lock(*m_mutexes[victim]);
+      if (m_queues[victim].empty()) continue;
+      task = m_queues[victim].back();
+      m_queues[victim].pop_back();
+      return true;
+    }
+    return false;
+  }
+
+  void WorkStealingPool::run(fuint32_t nbTasks, const std::function<void(fuint32_t)> &task)
+  {
+    for (fuint32_t i = 0; i < nbTasks; i++) m_queues[i % m_queues.size()].push_back(i);
+
+    std::exception_ptr error = nullptr;
+    std::mutex errorMutex;
+    auto work = [&](fuint32_t worker)
+    {
+      fuint32_t next = 0;
+      while (nextTask(worker, next))
+      {
+        try
+        {
+          task(next);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(errorMutex);
+          if (error == nullptr) error = std::current_exception();
+        }
+      }
+    };
+
+    std::vector<std::thread> threads{};
+    for (fuint32_t worker = 1; worker < m_queues.size(); worker++) threads.emplace_back(work, worker);
+    work(0);
+    for (auto &thread : threads) thread.join();
+    if (error != nullptr) std::rethrow_exception(error);
+  }
+
+  void copyModel(SCIP *source, const std::vector<SCIPVariable> &variables, ModelCopy &copy, const std::string &suffix)
+  {
+    std::lock_guard<std::mutex> lock(copyMutex);
+    SCIP_CALL_EXC(SCIPcreate(&copy.scip));
+
+    SCIP_HASHMAP *varmap = nullptr;
+    SCIP_Bool valid = FALSE;
+    SCIP_CALL_EXC(SCIPhashmapCreate(&varmap, SCIPblkmem(copy.scip), SCIPgetNVars(source)));
+    SCIP_RETCODE copied = SCIPcopyOrig(source, copy.scip, varmap, NULL, suffix.c_str(), FALSE, TRUE, FALSE, &valid);
+    if (copied == SCIP_OKAY)
+    {
+      copy.vars.resize(variables.size());
+      for (fuint32_t i = 0; i < variables.size(); i++)
+      {
+        copy.vars[i] = reinterpret_cast<SCIP_VAR*>(SCIPhashmapGetImage(varmap, variables[i].variable));
+      }
+    }
+    SCIPhashmapFree(&varmap);
+    if (copied != SCIP_OKAY) throw SCIPException(copied);
+    if (!valid) throw std::logic_error("Model cannot be copied completely (user plugins are not copied)...");
+    SCIP_CALL_EXC(SCIPcopyParamSettings(source, copy.scip));
+    SCIP_CALL_EXC(SCIPsetIntParam(copy.scip, "display/verblevel", 0)); // copies are solved at the same time
+  }
+
+  void includeIncumbentSharing(SCIP *scip, SharedIncumbent *incumbent)
+  {
+    SCIP_EVENTHDLR *eventhdlr = nullptr;
+    SCIP_CALL_EXC(SCIPincludeEventhdlrBasic(scip, &eventhdlr, EVENTHDLR_NAME, "objective limit from the other copies",
+                                            incumbentExec, reinterpret_cast<SCIP_EVENTHDLRDATA*>(incumbent)));
+    SCIP_CALL_EXC(SCIPsetEventhdlrInit(scip, eventhdlr, incumbentInit));
+  }
+
+  void includeInterruption(SCIP *scip, std::atomic<bool> *stop)
+  {
+    SCIP_EVENTHDLR *eventhdlr = nullptr;
+    SCIP_CALL_EXC(SCIPincludeEventhdlrBasic(scip, &eventhdlr, INTERRUPT_EVENTHDLR_NAME, "stops once another copy has finished",
+                                            interruptExec, reinterpret_cast<SCIP_EVENTHDLRDATA*>(stop)));
+    SCIP_CALL_EXC(SCIPsetEventhdlrInit(scip, eventhdlr, interruptInit));
+  }
+
+  void applyConfig(SCIP *scip, const SolverConfig &config)
+  { // the settings reset the parameters they cover to their defaults first, the changed parameters (verbosity, limits,
+    // symmetry handling, ...) are kept and the DEFAULT settings are skipped as they would only reset parameters
+    std::vector<ParamValue> changed = getChangedParams(scip);
+    if (config.emphasis != SCIP_PARAMEMPHASIS_DEFAULT) SCIP_CALL_EXC(SCIPsetEmphasis(scip, config.emphasis, TRUE));
+    if (config.presolving != SCIP_PARAMSETTING_DEFAULT) SCIP_CALL_EXC(SCIPsetPresolving(scip, config.presolving, TRUE));
+    if (config.heuristics != SCIP_PARAMSETTING_DEFAULT) SCIP_CALL_EXC(SCIPsetHeuristics(scip, config.heuristics, TRUE));
+    restoreParams(scip, changed);
+    SCIP_CALL_EXC(SCIPsetIntParam(scip, "randomization/randomseedshift", config.seedShift));
+    for (const auto &parameter : config.parameters)
+    {
+      const char *name = parameter.first.c_str();
+      SCIP_PARAM *param = SCIPgetParam(scip, name);
+      if (param == nullptr) throw std::invalid_argument("Unknown parameter " + parameter.first + "...");
+      switch (SCIPparamGetType(param))
+      {
+        case SCIP_PARAMTYPE_BOOL: SCIP_CALL_EXC(SCIPsetBoolParam(scip, name, parameter.second != 0.0)); break;
+        case SCIP_PARAMTYPE_INT: SCIP_CALL_EXC(SCIPsetIntParam(scip, name, static_cast<int>(parameter.second))); break;
+        case SCIP_PARAMTYPE_LONGINT: SCIP_CALL_EXC(SCIPsetLongintParam(scip, name, static_cast<SCIP_Longint>(parameter.second))); break;
+        case SCIP_PARAMTYPE_REAL: SCIP_CALL_EXC(SCIPsetRealParam(scip, name, parameter.second)); break;
+        default: throw std::invalid_argument("Parameter " + parameter.first + " is not numerical...");
+      }
+    }
+  }
+
+  std::vector<fuint32_t> chooseSplitVariables(const std::vector<SCIPVariable> &variables, fuint32_t nbSplits)
+  {
+    std::vector<fuint32_t> candidates{};
+    for (fuint32_t i = 0; i < variables.size(); i++)
+    {
+      if (SCIPvarGetType(variables[i].variable) == SCIP_VARTYPE_BINARY) candidates.push_back(i);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [&](fuint32_t a, fuint32_t b)
+    {
+      SCIP_VAR *varA = variables[a].variable;
+      SCIP_VAR *varB = variables[b].variable;
+      if (SCIPvarGetBranchPriority(varA) != SCIPvarGetBranchPriority(varB))
+      {
+        return SCIPvarGetBranchPriority(varA) > SCIPvarGetBranchPriority(varB);
+      }
+      return std::abs(SCIPvarGetObj(varA)) > std::abs(SCIPvarGetObj(varB));
+    });
+    if (candidates.size() > nbSplits) candidates.resize(nbSplits);
+    return candidates;
+  }
+}
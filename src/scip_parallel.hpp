@@ -0,0 +1,69 @@
+#ifndef SCIP_PARALLEL_HPP
+#define SCIP_PARALLEL_HPP
+
+#include "scip_wrapper.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <deque>
+
+/*
+ * Copies of a model which are solved by several threads at once.
+ * Only used internally by the MILPSolver.
+ */
+
+namespace scip_wrapper
+{
+  struct SharedIncumbent
+  { // best objective value found by any copy (in the sense of the original problem)
+    SharedIncumbent(SCIP_OBJSENSE _sense)
+      : sense(_sense), objective(_sense == SCIP_OBJSENSE_MINIMIZE ? std::numeric_limits<double>::infinity()
+                                                                  : -std::numeric_limits<double>::infinity()) {}
+
+    bool isBetter(double a, double b) const { return sense == SCIP_OBJSENSE_MINIMIZE ? a < b : a > b; }
+    bool update(double value); // returns whether value improved the incumbent
+    double get() const { return objective.load(); }
+
+    public:
+      SCIP_OBJSENSE sense;
+      std::atomic<double> objective;
+  };
+
+  struct ModelCopy
+  { // copy of the original problem, vars[i] is the copy of the wrapper's variable i
+    ModelCopy() : scip(nullptr) {}
+    ModelCopy(const ModelCopy&) = delete;
+    ~ModelCopy();
+
+    public:
+      SCIP *scip;
+      std::vector<SCIP_VAR*> vars;
+  };
+
+  class WorkStealingPool
+  { // every worker has its own queue of tasks, idle workers steal from the back of the other queues
+    public:
+      WorkStealingPool(fuint32_t nbWorkers);
+      void run(fuint32_t nbTasks, const std::function<void(fuint32_t)> &task); // rethrows the first exception of a task
+
+    private:
+      bool nextTask(fuint32_t worker, fuint32_t &task);
+
+    private:
+      std::vector<std::deque<fuint32_t>> m_queues;
+      std::vector<std::unique_ptr<std::mutex>> m_mutexes;
+  };
+
+  // copying is serialized as SCIPcopyOrig is not safe while the source is read by other copies,
+  // throws if the model cannot be copied completely (e.g. because of user plugins)
+  void copyModel(SCIP *source, const std::vector<SCIPVariable> &variables, ModelCopy &copy, const std::string &suffix);
+  // the copy reports its incumbents and tightens its objective limit to the incumbents of the other copies
+  void includeIncumbentSharing(SCIP *scip, SharedIncumbent *incumbent);
+  // the copy interrupts itself once stop is set (checked after every LP and node)
+  void includeInterruption(SCIP *scip, std::atomic<bool> *stop);
+  void applyConfig(SCIP *scip, const SolverConfig &config);
+  // binaries with the highest branching priority, ties are broken by the absolute objective coefficient
+  std::vector<fuint32_t> chooseSplitVariables(const std::vector<SCIPVariable> &variables, fuint32_t nbSplits);
+}
+
+#endif
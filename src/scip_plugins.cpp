@@ -0,0 +1,483 @@
+#include "scip_plugins.hpp"
+
+// constraint handler properties of the lazy constraint handlers
+#define LAZY_ENFOPRIORITY -1000    // enforce after the integrality constraint
+#define LAZY_CHECKPRIORITY -1000   // check after all other constraint handlers
+#define LAZY_SEPAPRIORITY 0
+#define LAZY_SEPAFREQ 1
+#define LAZY_EAGERFREQ -1
+
+// heuristic properties of the user heuristics
+#define HEUR_DISPCHAR 'U'
+#define HEUR_PRIORITY 0
+#define HEUR_MAXDEPTH -1
+
+// branching rule properties of the user branching rules
+#define BRANCHRULE_PRIORITY 1000000 // ask the user before SCIP's own branching rules
+#define BRANCHRULE_MAXDEPTH -1
+#define BRANCHRULE_MAXBOUNDDIST 1.0
+
+// pricer properties of the user pricers
+#define PRICER_PRIORITY 0
+#define PRICER_DELAY TRUE // only price if no other pricer found columns
+
+namespace scip_wrapper
+{
+  namespace
+  {
+    template<typename T>
+    T* getHandler(SCIP_CONSHDLR *conshdlr)
+    {
+      return reinterpret_cast<T*>(SCIPconshdlrGetData(conshdlr));
+    }
+
+    SCIP_RETCODE callRowCallback(SCIP *scip, const RowCallback &callback, SolutionBuffer &solution, SCIP_SOL *sol,
+                                 std::vector<LinearRow> &rows)
+    {
+      SCIP_CALL(solution.load(scip, sol));
+      try
+      {
+        rows = callback(solution.view());
+      }
+      catch (const std::exception &e)
+      { // exceptions must not pass through SCIP
+        SCIPerrorMessage("User callback failed: %s\n", e.what());
+        return SCIP_ERROR;
+      }
+      return SCIP_OKAY;
+    }
+
+    template<typename CreateEmptyRow>
+    SCIP_RETCODE addViolatedRows(SCIP *scip, const std::vector<LinearRow> &rows, const SolutionBuffer &solution,
+                                 CreateEmptyRow createEmptyRow, fuint32_t &nbRowsAdded, SCIP_RESULT *result)
+    { // result is SCIP_CUTOFF, SCIP_SEPARATED or left unchanged if no row was added
+      bool infeasible = false;
+      for (auto it = rows.begin(); it != rows.end() && !infeasible; ++it)
+      {
+        if (getViolation(*it, solution.view()) <= SCIPfeastol(scip)) continue;
+
+        SCIP_ROW *row;
+        SCIP_CALL(createEmptyRow(&row, it->lhs == -INF_BOUND ? -SCIPinfinity(scip) : it->lhs,
+                                 it->rhs == INF_BOUND ? SCIPinfinity(scip) : it->rhs));
+        SCIP_CALL(addRowToLP(scip, row, *it, solution.transformedVars, &infeasible));
+        nbRowsAdded++;
+        *result = SCIP_SEPARATED;
+      }
+      if (infeasible) *result = SCIP_CUTOFF;
+      return SCIP_OKAY;
+    }
+
+    SCIP_RETCODE separateLazyRows(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_SOL *sol, bool enforce, SCIP_RESULT *result)
+    {
+      auto *handler = getHandler<LazyConstraintHandler>(conshdlr);
+      std::vector<LinearRow> rows{};
+      SCIP_CALL(callRowCallback(scip, handler->callback, handler->solution, sol, rows));
+
+      *result = enforce ? SCIP_FEASIBLE : SCIP_DIDNOTFIND;
+      return addViolatedRows(scip, rows, handler->solution, [&](SCIP_ROW **row, double lhs, double rhs)
+      {
+        return SCIPcreateEmptyRowConshdlr(scip, row, conshdlr, "lazy", lhs, rhs, FALSE, FALSE, TRUE);
+      }, handler->nbRowsAdded, result);
+    }
+
+    SCIP_RETCODE separateCuts(SCIP *scip, SCIP_SEPA *sepa, SCIP_SOL *sol, SCIP_RESULT *result)
+    {
+      auto *handler = reinterpret_cast<SeparatorHandler*>(SCIPsepaGetData(sepa));
+      std::vector<LinearRow> rows{};
+      SCIP_CALL(callRowCallback(scip, handler->callback, handler->solution, sol, rows));
+
+      *result = SCIP_DIDNOTFIND;
+      return addViolatedRows(scip, rows, handler->solution, [&](SCIP_ROW **row, double lhs, double rhs)
+      {
+        return SCIPcreateEmptyRowSepa(scip, row, sepa, handler->name.c_str(), lhs, rhs, FALSE, FALSE, TRUE);
+      }, handler->nbCutsAdded, result);
+    }
+
+    SCIP_RETCODE tryAssignment(SCIP *scip, HeuristicHandler *handler, const Assignment &assignment, bool &stored)
+    { // values of fixed and multi-aggregated variables are implied by the other values and cannot be set
+      const auto &transformedVars = handler->solution.transformedVars;
+      if (assignment.size() != transformedVars.size())
+      { // a faulty candidate is discarded, the solving continues
+        SCIPwarningMessage(scip, "Heuristic <%s> returned %d values for %d variables, candidate discarded.\n", handler->name.c_str(),
+                           static_cast<int>(assignment.size()), static_cast<int>(transformedVars.size()));
+        stored = false;
+        return SCIP_OKAY;
+      }
+
+      SCIP_SOL *sol;
+      SCIP_CALL(SCIPcreateSol(scip, &sol, handler->heuristic));
+      for (std::size_t i = 0; i < transformedVars.size(); i++)
+      {
+        SCIP_VARSTATUS status = SCIPvarGetStatus(transformedVars[i]);
+        if (status == SCIP_VARSTATUS_FIXED || status == SCIP_VARSTATUS_MULTAGGR) continue;
+        SCIP_CALL(SCIPsetSolVal(scip, sol, transformedVars[i], assignment[i]));
+      }
+
+      SCIP_CONSHDLR *indicatorHdlr = SCIPfindConshdlr(scip, "indicator");
+      if (indicatorHdlr != NULL)
+      {
+        SCIP_Bool changed;
+        SCIP_CALL(SCIPmakeIndicatorsFeasible(scip, indicatorHdlr, sol, &changed));
+      }
+
+      SCIP_Bool isStored = FALSE;
+      SCIP_CALL(SCIPtrySolFree(scip, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &isStored));
+      stored = isStored;
+      return SCIP_OKAY;
+    }
+  }
+
+  SCIP_RETCODE SolutionBuffer::load(SCIP *scip, SCIP_SOL *sol)
+  { // the transformed variables change with every transformation, so they are looked up each time
+    transformedVars.resize(variables.size());
+    values.resize(variables.size());
+    for (std::size_t i = 0; i < variables.size(); i++)
+    {
+      SCIP_CALL(SCIPgetTransformedVar(scip, variables[i].variable, &transformedVars[i]));
+    }
+    SCIP_CALL(SCIPgetSolVals(scip, sol, transformedVars.size(), transformedVars.data(), values.data()));
+    return SCIP_OKAY;
+  }
+
+  void LazyRowPool::addRow(const LinearRow &row)
+  {
+    columns.insert(columns.end(), row.vars.begin(), row.vars.end());
+    values.insert(values.end(), row.coefficients.begin(), row.coefficients.end());
+    rowStarts.push_back(columns.size());
+    lhs.push_back(row.lhs);
+    rhs.push_back(row.rhs);
+  }
+
+  std::vector<LinearRow> LazyRowPool::findViolatedRows(SolutionView solution, double tolerance)
+  { // the activities of all rows are computed in one pass over the pool before any row is materialized
+    const fuint32_t nbRows = size();
+    activities.resize(nbRows);
+    const fuint32_t *cols = columns.data();
+    const double *coefs = values.data();
+    const double *x = solution.begin();
+    for (fuint32_t r = 0; r < nbRows; r++)
+    {
+      double activity = 0.0;
+      for (fuint32_t k = rowStarts[r]; k < rowStarts[r + 1]; k++)
+      {
+        activity += coefs[k] * x[cols[k]];
+      }
+      activities[r] = activity;
+    }
+
+    std::vector<LinearRow> violated{};
+    for (fuint32_t r = 0; r < nbRows; r++)
+    {
+      if (activities[r] <= rhs[r] + tolerance && activities[r] >= lhs[r] - tolerance) continue;
+      LinearRow row{lhs[r], rhs[r]};
+      row.vars.assign(columns.begin() + rowStarts[r], columns.begin() + rowStarts[r + 1]);
+      row.coefficients.assign(values.begin() + rowStarts[r], values.begin() + rowStarts[r + 1]);
+      violated.push_back(row);
+    }
+    return violated;
+  }
+
+  double getViolation(const LinearRow &row, SolutionView values)
+  {
+    double activity = 0.0;
+    for (fuint32_t i = 0; i < row.vars.size(); i++)
+    {
+      activity += row.coefficients[i] * values[row.vars[i]];
+    }
+    return std::max(0.0, std::max(row.lhs - activity, activity - row.rhs));
+  }
+
+  SCIP_RETCODE addRowToLP(SCIP *scip, SCIP_ROW *row, const LinearRow &linearRow,
+                          const std::vector<SCIP_VAR*> &transformedVars, bool *infeasible)
+  { // adds the variables of the linear row to an empty SCIP row, passes it to the LP and releases it
+    SCIP_CALL(SCIPcacheRowExtensions(scip, row));
+    for (fuint32_t i = 0; i < linearRow.vars.size(); i++)
+    {
+      SCIP_CALL(SCIPaddVarToRow(scip, row, transformedVars[linearRow.vars[i]], linearRow.coefficients[i]));
+    }
+    SCIP_CALL(SCIPflushRowExtensions(scip, row));
+
+    SCIP_Bool cutoff = FALSE;
+    SCIP_CALL(SCIPaddRow(scip, row, FALSE, &cutoff));
+    SCIP_CALL(SCIPreleaseRow(scip, &row));
+    *infeasible = cutoff;
+    return SCIP_OKAY;
+  }
+}
+
+using namespace scip_wrapper;
+
+static SCIP_DECL_CONSENFOLP(lazyEnfolp)
+{
+  return separateLazyRows(scip, conshdlr, NULL, true, result);
+}
+
+static SCIP_DECL_CONSENFOPS(lazyEnfops)
+{ // no LP available: the violated rows are added as constraints
+  auto *handler = reinterpret_cast<LazyConstraintHandler*>(SCIPconshdlrGetData(conshdlr));
+  std::vector<LinearRow> rows{};
+  SCIP_CALL(callRowCallback(scip, handler->callback, handler->solution, NULL, rows));
+
+  *result = SCIP_FEASIBLE;
+  for (const auto &linearRow : rows)
+  {
+    if (getViolation(linearRow, handler->solution.view()) <= SCIPfeastol(scip)) continue;
+
+    std::vector<SCIP_VAR*> vars{};
+    for (auto var : linearRow.vars) vars.push_back(handler->solution.transformedVars[var]);
+
+    SCIP_CONS *cons;
+    SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, "lazy", vars.size(), vars.data(),
+                                        const_cast<double*>(linearRow.coefficients.data()),
+                                        linearRow.lhs == -INF_BOUND ? -SCIPinfinity(scip) : linearRow.lhs,
+                                        linearRow.rhs == INF_BOUND ? SCIPinfinity(scip) : linearRow.rhs));
+    SCIP_CALL(SCIPaddCons(scip, cons));
+    SCIP_CALL(SCIPreleaseCons(scip, &cons));
+    handler->nbRowsAdded++;
+    *result = SCIP_CONSADDED;
+  }
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSCHECK(lazyCheck)
+{
+  auto *handler = reinterpret_cast<LazyConstraintHandler*>(SCIPconshdlrGetData(conshdlr));
+  std::vector<LinearRow> rows{};
+  SCIP_CALL(callRowCallback(scip, handler->callback, handler->solution, sol, rows));
+
+  *result = SCIP_FEASIBLE;
+  for (const auto &linearRow : rows)
+  {
+    if (getViolation(linearRow, handler->solution.view()) > SCIPfeastol(scip))
+    {
+      *result = SCIP_INFEASIBLE;
+      break;
+    }
+  }
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSLOCK(lazyLock)
+{ // the rows are unknown in advance, so every variable may be restricted in both directions
+  auto *handler = reinterpret_cast<LazyConstraintHandler*>(SCIPconshdlrGetData(conshdlr));
+  for (const auto &var : handler->solution.variables)
+  {
+    SCIP_VAR *transformedVar = nullptr;
+    SCIP_CALL(SCIPgetTransformedVar(scip, var.variable, &transformedVar));
+    if (transformedVar == nullptr) continue;
+    SCIP_CALL(SCIPaddVarLocksType(scip, transformedVar, locktype, nlockspos + nlocksneg, nlockspos + nlocksneg));
+  }
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSSEPALP(lazySepalp)
+{
+  return separateLazyRows(scip, conshdlr, NULL, false, result);
+}
+
+static SCIP_DECL_CONSSEPASOL(lazySepasol)
+{
+  return separateLazyRows(scip, conshdlr, sol, false, result);
+}
+
+static SCIP_DECL_SEPAEXECLP(userSepaExeclp)
+{
+  return separateCuts(scip, sepa, NULL, result);
+}
+
+static SCIP_DECL_SEPAEXECSOL(userSepaExecsol)
+{
+  return separateCuts(scip, sepa, sol, result);
+}
+
+static SCIP_DECL_HEUREXEC(userHeurExec)
+{
+  auto *handler = reinterpret_cast<HeuristicHandler*>(SCIPheurGetData(heur));
+  *result = SCIP_DIDNOTRUN;
+  if (SCIPgetStage(scip) != SCIP_STAGE_SOLVING) return SCIP_OKAY; // only node solutions are passed to the callback
+
+  SCIP_CALL(handler->solution.load(scip, NULL));
+  std::vector<Assignment> assignments{};
+  try
+  {
+    assignments = handler->callback(handler->solution.view());
+  }
+  catch (const std::exception &e)
+  { // exceptions must not pass through SCIP
+    SCIPerrorMessage("User heuristic failed: %s\n", e.what());
+    return SCIP_ERROR;
+  }
+
+  *result = SCIP_DIDNOTFIND;
+  for (const auto &assignment : assignments)
+  {
+    bool stored = false;
+    SCIP_CALL(tryAssignment(scip, handler, assignment, stored));
+    if (!stored) continue;
+    handler->nbSolutionsStored++;
+    *result = SCIP_FOUNDSOL;
+  }
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_BRANCHEXECLP(userBranchExeclp)
+{
+  auto *handler = reinterpret_cast<BranchingHandler*>(SCIPbranchruleGetData(branchrule));
+  *result = SCIP_DIDNOTRUN;
+  SCIP_CALL(handler->solution.load(scip, NULL));
+
+  SCIP_VAR **lpCands;
+  int nbLpCands;
+  SCIP_CALL(SCIPgetLPBranchCands(scip, &lpCands, NULL, NULL, &nbLpCands, NULL, NULL));
+  std::map<SCIP_VAR*, fuint32_t> wrapperIndices{};
+  for (fuint32_t i = 0; i < handler->solution.transformedVars.size(); i++)
+  {
+    wrapperIndices.insert(std::make_pair(handler->solution.transformedVars[i], i));
+  }
+  handler->candidates.clear();
+  for (int i = 0; i < nbLpCands; i++)
+  { // candidates created by SCIP itself have no wrapper index
+    auto it = wrapperIndices.find(lpCands[i]);
+    if (it != wrapperIndices.end()) handler->candidates.push_back(it->second);
+  }
+
+  fuint32_t branchVar = NO_VARIABLE;
+  try
+  {
+    branchVar = handler->callback(handler->solution.view(), VariableSpan{handler->candidates});
+  }
+  catch (const std::exception &e)
+  { // exceptions must not pass through SCIP
+    SCIPerrorMessage("User branching rule failed: %s\n", e.what());
+    return SCIP_ERROR;
+  }
+  if (branchVar == NO_VARIABLE) return SCIP_OKAY;
+  // SCIPbranchVar fails for fixed, continuous or LP-integral variables, SCIP's own rules take over then
+  if (std::find(handler->candidates.begin(), handler->candidates.end(), branchVar) == handler->candidates.end()) return SCIP_OKAY;
+
+  SCIP_CALL(SCIPbranchVar(scip, handler->solution.transformedVars[branchVar], NULL, NULL, NULL));
+  *result = SCIP_BRANCHED;
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_PRICERINIT(userPricerInit)
+{ // the transformed rows change with every solve, priced columns of earlier solves are gone
+  auto *handler = reinterpret_cast<PricerHandler*>(SCIPpricerGetData(pricer));
+  handler->columns.clear();
+  handler->transformedRows.resize(handler->rows.size());
+  for (fuint32_t i = 0; i < handler->rows.size(); i++)
+  {
+    SCIP_CALL(SCIPgetTransformedCons(scip, handler->csts[handler->rows[i]].constraint, &handler->transformedRows[i]));
+  }
+  return SCIP_OKAY;
+}
+
+static SCIP_RETCODE priceColumns(SCIP *scip, SCIP_PRICER *pricer, bool farkas, SCIP_RESULT *result)
+{ // the transformed problem is a minimization, duals are passed in the sense of the original problem
+  auto *handler = reinterpret_cast<PricerHandler*>(SCIPpricerGetData(pricer));
+  const double sign = (farkas || SCIPgetObjsense(scip) == SCIP_OBJSENSE_MINIMIZE) ? 1.0 : -1.0;
+  handler->duals.resize(handler->rows.size());
+  for (fuint32_t i = 0; i < handler->rows.size(); i++)
+  {
+    handler->duals[i] = sign * (farkas ? SCIPgetDualfarkasLinear(scip, handler->transformedRows[i])
+                                       : SCIPgetDualsolLinear(scip, handler->transformedRows[i]));
+  }
+
+  PricedColumnVec columns{};
+  try
+  {
+    columns = handler->callback(CoefficientSpan{handler->duals}, farkas);
+  }
+  catch (const std::exception &e)
+  { // exceptions must not pass through SCIP
+    SCIPerrorMessage("User pricer failed: %s\n", e.what());
+    return SCIP_ERROR;
+  }
+
+  *result = SCIP_SUCCESS;
+  for (const auto &column : columns)
+  {
+    if (handler->columns.count(column.tag) != 0) continue;
+    if (!farkas)
+    { // reduced cost in the transformed (minimization) problem
+      double reducedCost = column.objective;
+      for (fuint32_t i = 0; i < column.rows.size(); i++) reducedCost -= handler->duals[column.rows[i]] * column.coefficients[i];
+      if (sign * reducedCost >= -SCIPdualfeastol(scip)) continue;
+    }
+
+    SCIP_VAR *var;
+    SCIP_VARTYPE type = !column.integral ? SCIP_VARTYPE_CONTINUOUS
+                        : (column.upperBound == 1.0 ? SCIP_VARTYPE_BINARY : SCIP_VARTYPE_INTEGER);
+    std::string name = handler->name + "_" + std::to_string(column.tag);
+    SCIP_CALL(SCIPcreateVar(scip, &var, name.c_str(), 0.0, column.upperBound,
+      (SCIPgetObjsense(scip) == SCIP_OBJSENSE_MINIMIZE ? 1.0 : -1.0) * column.objective, type,
+      TRUE, TRUE, NULL, NULL, NULL, NULL, NULL));
+    SCIP_CALL(SCIPaddPricedVar(scip, var, 1.0));
+    for (fuint32_t i = 0; i < column.rows.size(); i++)
+    {
+      SCIP_CALL(SCIPaddCoefLinear(scip, handler->transformedRows[column.rows[i]], var, column.coefficients[i]));
+    }
+    handler->columns.insert(std::make_pair(column.tag, var));
+    SCIP_CALL(SCIPreleaseVar(scip, &var));
+  }
+  return SCIP_OKAY;
+}
+
+static SCIP_DECL_PRICERREDCOST(userPricerRedcost)
+{
+  return priceColumns(scip, pricer, false, result);
+}
+
+static SCIP_DECL_PRICERFARKAS(userPricerFarkas)
+{
+  return priceColumns(scip, pricer, true, result);
+}
+
+namespace scip_wrapper
+{
+  void includeLazyConstraintHandler(SCIP *scip, LazyConstraintHandler *handler, const std::string &name, bool separate)
+  {
+    SCIP_CONSHDLR *conshdlr = nullptr;
+    SCIP_CALL_EXC(SCIPincludeConshdlrBasic(scip, &conshdlr, name.c_str(), "lazy constraints of a user callback",
+                                           LAZY_ENFOPRIORITY, LAZY_CHECKPRIORITY, LAZY_EAGERFREQ, FALSE,
+                                           lazyEnfolp, lazyEnfops, lazyCheck, lazyLock,
+                                           reinterpret_cast<SCIP_CONSHDLRDATA*>(handler)));
+    if (separate)
+    {
+      SCIP_CALL_EXC(SCIPsetConshdlrSepa(scip, conshdlr, lazySepalp, lazySepasol, LAZY_SEPAFREQ, LAZY_SEPAPRIORITY, FALSE));
+    }
+  }
+
+  void includeSeparator(SCIP *scip, SeparatorHandler *handler, int priority, int frequency)
+  {
+    SCIP_CALL_EXC(SCIPincludeSepaBasic(scip, &handler->separator, handler->name.c_str(), "separator of a user callback",
+                                       priority, frequency, 1.0, FALSE, FALSE, userSepaExeclp, userSepaExecsol,
+                                       reinterpret_cast<SCIP_SEPADATA*>(handler)));
+  }
+
+  void includeHeuristic(SCIP *scip, HeuristicHandler *handler, SCIP_HEURTIMING timing, int frequency)
+  {
+    SCIP_CALL_EXC(SCIPincludeHeurBasic(scip, &handler->heuristic, handler->name.c_str(), "heuristic of a user callback",
+                                       HEUR_DISPCHAR, HEUR_PRIORITY, frequency, 0, HEUR_MAXDEPTH, timing, FALSE,
+                                       userHeurExec, reinterpret_cast<SCIP_HEURDATA*>(handler)));
+  }
+
+  void includeBranchingRule(SCIP *scip, BranchingHandler *handler)
+  {
+    SCIP_BRANCHRULE *branchrule = nullptr;
+    SCIP_CALL_EXC(SCIPincludeBranchruleBasic(scip, &branchrule, handler->name.c_str(), "branching rule of a user callback",
+                                             BRANCHRULE_PRIORITY, BRANCHRULE_MAXDEPTH, BRANCHRULE_MAXBOUNDDIST,
+                                             reinterpret_cast<SCIP_BRANCHRULEDATA*>(handler)));
+    SCIP_CALL_EXC(SCIPsetBranchruleExecLp(scip, branchrule, userBranchExeclp));
+  }
+
+  void includePricer(SCIP *scip, PricerHandler *handler)
+  {
+    SCIP_PRICER *pricer = nullptr;
+    SCIP_CALL_EXC(SCIPincludePricerBasic(scip, &pricer, handler->name.c_str(), "pricer of a user callback",
+                                         PRICER_PRIORITY, PRICER_DELAY, userPricerRedcost, userPricerFarkas,
+                                         reinterpret_cast<SCIP_PRICERDATA*>(handler)));
+    SCIP_CALL_EXC(SCIPsetPricerInit(scip, pricer, userPricerInit));
+    SCIP_CALL_EXC(SCIPactivatePricer(scip, pricer));
+  }
+}
@@ -0,0 +1,118 @@
+#ifndef SCIP_PLUGINS_HPP
+#define SCIP_PLUGINS_HPP
+
+#include "scip_wrapper.hpp"
+
+/*
+ * SCIP plugins (constraint handlers, separators, ...) which forward to user callbacks.
+ * Only used internally by the MILPSolver.
+ */
+
+namespace scip_wrapper
+{
+  struct SolutionBuffer
+  { // dense values of the wrapper's variables in a solution of the transformed problem
+    SolutionBuffer(const std::vector<SCIPVariable> &_variables)
+      : variables(_variables) {}
+
+    SCIP_RETCODE load(SCIP *scip, SCIP_SOL *sol); // sol == NULL: current LP or pseudo solution
+    SolutionView view() const { return SolutionView{values.data(), values.size()}; }
+
+    public:
+      const std::vector<SCIPVariable> &variables;
+      std::vector<SCIP_VAR*> transformedVars;
+      std::vector<double> values;
+  };
+
+  struct LazyConstraintHandler
+  {
+    LazyConstraintHandler(const std::vector<SCIPVariable> &variables, LazyConstraintCallback _callback)
+      : solution(variables), callback(_callback), nbRowsAdded(0) {}
+
+    public:
+      SolutionBuffer solution;
+      LazyConstraintCallback callback;
+      fuint32_t nbRowsAdded;
+  };
+
+  struct LazyRowPool
+  { // rows kept outside of the LP in compressed sparse row format
+    void addRow(const LinearRow &row);
+    std::vector<LinearRow> findViolatedRows(SolutionView solution, double tolerance);
+    fuint32_t size() const { return lhs.size(); }
+
+    public:
+      std::vector<fuint32_t> rowStarts{0};
+      std::vector<fuint32_t> columns;
+      std::vector<double> values;
+      std::vector<double> lhs;
+      std::vector<double> rhs;
+      std::vector<double> activities; // buffer of the violation scan
+  };
+
+  struct SeparatorHandler
+  {
+    SeparatorHandler(const std::vector<SCIPVariable> &variables, SeparatorCallback _callback, const std::string &_name)
+      : solution(variables), callback(_callback), name(_name), separator(nullptr), nbCutsAdded(0) {}
+
+    public:
+      SolutionBuffer solution;
+      SeparatorCallback callback;
+      std::string name;
+      SCIP_SEPA *separator;
+      fuint32_t nbCutsAdded;
+  };
+
+  struct HeuristicHandler
+  {
+    HeuristicHandler(const std::vector<SCIPVariable> &variables, HeuristicCallback _callback, const std::string &_name)
+      : solution(variables), callback(_callback), name(_name), heuristic(nullptr), nbSolutionsStored(0) {}
+
+    public:
+      SolutionBuffer solution;
+      HeuristicCallback callback;
+      std::string name;
+      SCIP_HEUR *heuristic;
+      fuint32_t nbSolutionsStored;
+  };
+
+  struct BranchingHandler
+  {
+    BranchingHandler(const std::vector<SCIPVariable> &variables, BranchingCallback _callback, const std::string &_name)
+      : solution(variables), callback(_callback), name(_name) {}
+
+    public:
+      SolutionBuffer solution;
+      BranchingCallback callback;
+      std::string name;
+      std::vector<fuint32_t> candidates; // wrapper indices of the LP branching candidates
+  };
+
+  struct PricerHandler
+  {
+    PricerHandler(const std::vector<SCIPLinearConstraint> &_csts, const std::vector<fuint32_t> &_rows,
+                  PricingCallback _callback, const std::string &_name)
+      : csts(_csts), rows(_rows), callback(_callback), name(_name) {}
+
+    public:
+      const std::vector<SCIPLinearConstraint> &csts;
+      std::vector<fuint32_t> rows;
+      PricingCallback callback;
+      std::string name;
+      std::vector<SCIP_CONS*> transformedRows;
+      std::vector<double> duals;
+      std::map<fuint32_t, SCIP_VAR*> columns; // priced variables of the current solve by their tag
+  };
+
+  double getViolation(const LinearRow &row, SolutionView values);
+  SCIP_RETCODE addRowToLP(SCIP *scip, SCIP_ROW *row, const LinearRow &linearRow,
+                          const std::vector<SCIP_VAR*> &transformedVars, bool *infeasible);
+
+  void includeLazyConstraintHandler(SCIP *scip, LazyConstraintHandler *handler, const std::string &name, bool separate);
+  void includeSeparator(SCIP *scip, SeparatorHandler *handler, int priority, int frequency);
+  void includeHeuristic(SCIP *scip, HeuristicHandler *handler, SCIP_HEURTIMING timing, int frequency);
+  void includeBranchingRule(SCIP *scip, BranchingHandler *handler);
+  void includePricer(SCIP *scip, PricerHandler *handler);
+}
+
+#endif
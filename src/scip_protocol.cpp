@@ -0,0 +1,57 @@
+#include "scip_protocol.hpp"
+
+#include <sys/socket.h>
+#include <cerrno>
+
+using namespace scip_wrapper;
+
+namespace
+{
+  void sendAll(int fd, const char *data, std::size_t size)
+  {
+    while (size > 0)
+    { // MSG_NOSIGNAL: a closed peer is an error, not a SIGPIPE
+      ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+      if (sent < 0 && errno == EINTR) continue;
+      if (sent <= 0) throw std::runtime_error("Connection lost while sending...");
+      data += sent;
+      size -= sent;
+    }
+  }
+
+  std::size_t receiveAll(int fd, char *data, std::size_t size)
+  { // returns the number of bytes received before the peer closed the connection
+    std::size_t received = 0;
+    while (received < size)
+    {
+      ssize_t count = recv(fd, data + received, size - received, 0);
+      if (count < 0 && errno == EINTR) continue;
+      if (count < 0) throw std::runtime_error("Connection lost while receiving...");
+      if (count == 0) break;
+      received += count;
+    }
+    return received;
+  }
+}
+
+namespace scip_wrapper
+{
+  void sendMessage(int fd, const std::vector<char> &message)
+  {
+    uint64_t size = message.size();
+    sendAll(fd, reinterpret_cast<const char*>(&size), sizeof(size));
+    sendAll(fd, message.data(), message.size());
+  }
+
+  bool receiveMessage(int fd, std::vector<char> &message, uint64_t maxSize)
+  {
+    uint64_t size = 0;
+    std::size_t received = receiveAll(fd, reinterpret_cast<char*>(&size), sizeof(size));
+    if (received == 0) return false;
+    if (received != sizeof(size)) throw std::runtime_error("Connection closed within a message...");
+    if (size > maxSize) throw std::runtime_error("Message of " + std::to_string(size) + " bytes exceeds the limit...");
+    message.resize(size);
+    if (receiveAll(fd, message.data(), size) != size) throw std::runtime_error("Connection closed within a message...");
+    return true;
+  }
+}
@@ -0,0 +1,125 @@
+#ifndef SCIP_PROTOCOL_HPP
+#define SCIP_PROTOCOL_HPP
+
+#include "scip_types.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/*
+ * Binary encoding of the requests and responses exchanged by the daemon (scip_daemon.hpp) and its clients
+ * (scip_client.hpp) over a Unix domain socket. Every message is framed by its size (uint64_t) and starts with a fixed
+ * header followed by arrays. Both sides run on the same machine, thus values are stored in native byte order.
+ *
+ * MILP request: types (uint8_t), lower bounds, upper bounds, objective (per variable), lhs, rhs (per row),
+ *               row starts (uint64_t, nbRows + 1), variables (uint32_t) and coefficients (per nonzero)
+ * QUBO request: x, y (uint32_t), coefficients, penalty flags (uint8_t) (per term)
+ * response:     values (per variable), error message (chars)
+ */
+
+namespace scip_wrapper
+{
+  const uint32_t PROTOCOL_MAGIC = 0x44575343; // "CSWD"
+  const uint32_t PROTOCOL_VERSION = 1; // increased whenever the encoding changes
+
+  enum ProblemKind
+  {
+    MILP_PROBLEM,
+    QUBO_PROBLEM
+  };
+
+  enum SolveStatus
+  {
+    SOLVE_OPTIMAL,
+    SOLVE_FEASIBLE,    // a limit was hit, the values are the best solution found
+    SOLVE_INFEASIBLE,
+    SOLVE_NO_SOLUTION, // neither a solution nor a proof of infeasibility (e.g. the time limit was hit)
+    SOLVE_REJECTED,    // all workers busy and the queue full, or the time budget ran out while waiting
+    SOLVE_ERROR        // malformed request or failed solve, see the message
+  };
+
+  struct RequestHeader
+  {
+    uint32_t magic;
+    uint32_t version;
+    uint8_t problem; // ProblemKind
+    int8_t sense; // SolverSense
+    uint8_t reserved[6];
+    double timeLimit; // seconds including the time waiting for a worker, 0 for the daemon's default
+    double penalty; // QUBO only
+    uint64_t nbVars;
+    uint64_t nbRows; // MILP only
+    uint64_t nbNonzeros; // terms of a QUBO
+  };
+
+  struct ResponseHeader
+  {
+    uint32_t magic;
+    uint8_t status; // SolveStatus
+    uint8_t reserved[3];
+    double objective;
+    double solvingTime;
+    double waitingTime; // seconds spent waiting for a worker
+    int64_t nbNodes;
+    uint64_t nbValues;
+    uint64_t messageSize;
+  };
+
+  class MessageWriter
+  {
+    public:
+      template<typename T>
+      void put(const T &value) { putArray(&value, 1); }
+      template<typename T>
+      void putArray(const T *values, std::size_t count)
+      {
+        const char *bytes = reinterpret_cast<const char*>(values);
+        m_data.insert(m_data.end(), bytes, bytes + count * sizeof(T));
+      }
+      const std::vector<char> &getData() const { return m_data; }
+
+    private:
+      std::vector<char> m_data;
+  };
+
+  class MessageReader
+  { // throws if the message ends early
+    public:
+      MessageReader(const std::vector<char> &data) : m_data(data), m_position(0) {}
+
+      template<typename T>
+      T get()
+      {
+        T value{};
+        getArray(&value, 1);
+        return value;
+      }
+      template<typename T>
+      void getArray(T *values, std::size_t count)
+      {
+        if (count > (m_data.size() - m_position) / sizeof(T)) throw std::runtime_error("Message is truncated...");
+        std::memcpy(values, m_data.data() + m_position, count * sizeof(T));
+        m_position += count * sizeof(T);
+      }
+      template<typename T>
+      void getArray(std::vector<T> &values, std::size_t count)
+      {
+        if (count > (m_data.size() - m_position) / sizeof(T)) throw std::runtime_error("Message is truncated...");
+        values.resize(count);
+        getArray(values.data(), count);
+      }
+      bool atEnd() const { return m_position == m_data.size(); }
+
+    private:
+      const std::vector<char> &m_data;
+      std::size_t m_position;
+  };
+
+  void sendMessage(int fd, const std::vector<char> &message);
+  // false if the peer closed the connection before a new message, throws on errors and messages above maxSize
+  bool receiveMessage(int fd, std::vector<char> &message, uint64_t maxSize);
+}
+
+#endif
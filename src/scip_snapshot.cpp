@@ -0,0 +1,162 @@
+#include "scip_snapshot.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace scip_wrapper;
+
+#define SNAPSHOT_MAGIC "SCIPWSNP"
+#define WRITE_BUFFER_SIZE (1 << 22)
+
+namespace
+{
+  uint64_t pad(uint64_t size)
+  {
+    return (size + 7) & ~uint64_t{7};
+  }
+
+  uint64_t getPayloadSize(const SnapshotHeader &header)
+  {
+    return 3 * 8 * header.nbVars + pad(header.nbVars)
+      + 2 * 8 * header.nbRows + pad(header.nbRows) + 8 * (header.nbRows + 1)
+      + pad(4 * header.nbNonzeros) + 8 * header.nbNonzeros;
+  }
+
+  uint64_t updateChecksum(uint64_t checksum, const char *data, std::size_t size)
+  { // word-wise mixing (size is a multiple of 8), detects truncated and stale files, no cryptographic hash
+    for (std::size_t i = 0; i < size; i += 8)
+    {
+      uint64_t word = 0;
+      std::memcpy(&word, data + i, 8);
+      checksum ^= word * 0x9E3779B97F4A7C15ull;
+      checksum = ((checksum << 27) | (checksum >> 37)) * 0xC2B2AE3D27D4EB4Full;
+    }
+    return checksum;
+  }
+
+  template<typename T>
+  const T *getSection(const char *&position, uint64_t count)
+  {
+    const T *section = reinterpret_cast<const T*>(position);
+    position += pad(count * sizeof(T));
+    return section;
+  }
+}
+
+namespace scip_wrapper
+{
+  SnapshotWriter::SnapshotWriter(const std::string &path, const SnapshotHeader &header)
+    : m_path(path), m_file(std::fopen(path.c_str(), "wb")), m_header(header), m_buffer(WRITE_BUFFER_SIZE), m_bufferSize(0),
+      m_written(0), m_checksum(0)
+  {
+    if (m_file == nullptr) throw std::runtime_error("Cannot open " + path + "...");
+    std::memcpy(m_header.magic, SNAPSHOT_MAGIC, sizeof(m_header.magic));
+    m_header.version = SNAPSHOT_VERSION;
+    m_header.payloadSize = getPayloadSize(m_header);
+    m_header.checksum = 0;
+    m_header.reserved = 0;
+    write(m_header); // placeholder until the checksum is known
+  }
+
+  SnapshotWriter::~SnapshotWriter()
+  {
+    if (m_file != nullptr) std::fclose(m_file);
+  }
+
+  void SnapshotWriter::write(const char *data, std::size_t size)
+  {
+    while (size > 0)
+    {
+      std::size_t chunk = std::min(size, m_buffer.size() - m_bufferSize);
+      std::memcpy(m_buffer.data() + m_bufferSize, data, chunk);
+      m_bufferSize += chunk;
+      data += chunk;
+      size -= chunk;
+      if (m_bufferSize == m_buffer.size()) flush();
+    }
+  }
+
+  void SnapshotWriter::endSection()
+  {
+    const char zeros[8] = {};
+    write(zeros, pad(m_written + m_bufferSize) - (m_written + m_bufferSize));
+  }
+
+  void SnapshotWriter::flush()
+  { // the header is written before the first flush, thus only the payload enters the checksum
+    if (m_bufferSize == 0) return;
+    if (m_written > 0) m_checksum = updateChecksum(m_checksum, m_buffer.data(), m_bufferSize);
+    else m_checksum = updateChecksum(m_checksum, m_buffer.data() + sizeof(SnapshotHeader), m_bufferSize - sizeof(SnapshotHeader));
+    if (std::fwrite(m_buffer.data(), 1, m_bufferSize, m_file) != m_bufferSize) throw std::runtime_error("Error while writing " + m_path + "...");
+    m_written += m_bufferSize;
+    m_bufferSize = 0;
+  }
+
+  void SnapshotWriter::finish()
+  {
+    endSection();
+    flush();
+    if (m_written != sizeof(SnapshotHeader) + m_header.payloadSize) throw std::logic_error("Snapshot sections do not match the header...");
+    m_header.checksum = m_checksum;
+    bool valid = std::fseek(m_file, 0, SEEK_SET) == 0 && std::fwrite(&m_header, sizeof(SnapshotHeader), 1, m_file) == 1;
+    valid = std::fclose(m_file) == 0 && valid;
+    m_file = nullptr;
+    if (!valid) throw std::runtime_error("Error while writing " + m_path + "...");
+  }
+
+  MappedSnapshot::MappedSnapshot(const std::string &path)
+    : m_address(nullptr), m_size(0), m_header(nullptr), m_view{}
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path + "...");
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(SnapshotHeader))
+    {
+      close(fd);
+      throw std::runtime_error(path + " is no snapshot...");
+    }
+    m_size = status.st_size;
+    m_address = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping stays valid
+    if (m_address == MAP_FAILED) throw std::runtime_error("Cannot map " + path + "...");
+    madvise(m_address, m_size, MADV_SEQUENTIAL);
+
+    m_header = reinterpret_cast<const SnapshotHeader*>(m_address);
+    const char *payload = reinterpret_cast<const char*>(m_address) + sizeof(SnapshotHeader);
+    std::string error{};
+    if (std::memcmp(m_header->magic, SNAPSHOT_MAGIC, sizeof(m_header->magic)) != 0) error = path + " is no snapshot...";
+    else if (m_header->version != SNAPSHOT_VERSION)
+    {
+      error = path + " has snapshot version " + std::to_string(m_header->version) + ", expected "
+        + std::to_string(SNAPSHOT_VERSION) + "...";
+    }
+    else if (m_header->payloadSize != getPayloadSize(*m_header) || m_size != sizeof(SnapshotHeader) + m_header->payloadSize)
+    {
+      error = path + " is truncated...";
+    }
+    else if (updateChecksum(0, payload, m_header->payloadSize) != m_header->checksum) error = "Checksum of " + path + " does not match...";
+    if (!error.empty())
+    {
+      munmap(m_address, m_size);
+      throw std::runtime_error(error);
+    }
+
+    m_view.lowerBounds = getSection<double>(payload, m_header->nbVars);
+    m_view.upperBounds = getSection<double>(payload, m_header->nbVars);
+    m_view.objective = getSection<double>(payload, m_header->nbVars);
+    m_view.types = getSection<uint8_t>(payload, m_header->nbVars);
+    m_view.lhs = getSection<double>(payload, m_header->nbRows);
+    m_view.rhs = getSection<double>(payload, m_header->nbRows);
+    m_view.kinds = getSection<uint8_t>(payload, m_header->nbRows);
+    m_view.rowStarts = getSection<uint64_t>(payload, m_header->nbRows + 1);
+    m_view.vars = getSection<uint32_t>(payload, m_header->nbNonzeros);
+    m_view.coefficients = getSection<double>(payload, m_header->nbNonzeros);
+  }
+
+  MappedSnapshot::~MappedSnapshot()
+  {
+    munmap(m_address, m_size);
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef SCIP_SNAPSHOT_HPP
+#define SCIP_SNAPSHOT_HPP
+
+#include "scip_wrapper.hpp"
+
+#include <cstdio>
+
+/*
+ * Binary snapshots of a MILPSolver's model (see MILPSolver::writeSnapshot), loaded using mmap.
+ * Layout: a fixed header followed by the sections lower bounds, upper bounds, objective, types (columns),
+ * lhs, rhs, kinds (rows), row starts, variables and coefficients (compressed sparse rows).
+ * Every section starts at a multiple of 8 bytes, thus the mapped arrays are used in place.
+ * Only used internally by the MILPSolver.
+ */
+
+namespace scip_wrapper
+{
+  const uint32_t SNAPSHOT_VERSION = 1; // increased whenever the layout changes
+  const uint8_t SNAPSHOT_ROW = 0;
+  const uint8_t SNAPSHOT_LAZY_ROW = 1;
+
+  struct SnapshotHeader
+  {
+    char magic[8];
+    uint32_t version;
+    int32_t sense; // SCIP_OBJSENSE
+    uint64_t nbVars;
+    uint64_t nbRows;
+    uint64_t nbNonzeros;
+    uint64_t payloadSize; // bytes following the header
+    uint64_t checksum; // of the payload
+    uint64_t reserved;
+  };
+
+  struct SnapshotView
+  { // arrays of a mapped snapshot, infinite bounds and sides are stored as +-infinity
+    const double *lowerBounds;
+    const double *upperBounds;
+    const double *objective;
+    const uint8_t *types; // VariableType
+    const double *lhs;
+    const double *rhs;
+    const uint8_t *kinds;
+    const uint64_t *rowStarts; // nbRows + 1 entries
+    const uint32_t *vars;
+    const double *coefficients;
+  };
+
+  class SnapshotWriter
+  { // the sections are written in order through a buffer, the header is patched in at the end
+    public:
+      SnapshotWriter(const std::string &path, const SnapshotHeader &header);
+      SnapshotWriter(const SnapshotWriter&) = delete;
+      ~SnapshotWriter();
+
+      template<typename T>
+      void write(const T &value) { write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+      void write(const char *data, std::size_t size);
+      void endSection(); // pads to a multiple of 8 bytes
+      void finish();
+
+    private:
+      void flush();
+
+    private:
+      std::string m_path;
+      FILE *m_file;
+      SnapshotHeader m_header;
+      std::vector<char> m_buffer;
+      std::size_t m_bufferSize;
+      uint64_t m_written;
+      uint64_t m_checksum;
+  };
+
+  class MappedSnapshot
+  { // throws if the file is no snapshot, has another version or does not match its checksum
+    public:
+      MappedSnapshot(const std::string &path);
+      MappedSnapshot(const MappedSnapshot&) = delete;
+      ~MappedSnapshot();
+
+      const SnapshotHeader &getHeader() const { return *m_header; }
+      const SnapshotView &getView() const { return m_view; }
+
+    private:
+      void *m_address;
+      std::size_t m_size;
+      const SnapshotHeader *m_header;
+      SnapshotView m_view;
+  };
+}
+
+#endif
@@ -0,0 +1,180 @@
+#include "scip_tuning.hpp"
+#include "scip_parallel.hpp"
+
+#include <dirent.h>
+#include <random>
+
+using namespace scip_wrapper;
+
+#define TIME_SHIFT 1.0 // seconds, keeps very easy runs from dominating the geometric mean
+
+namespace
+{
+  bool hasSuffix(const std::string &name, const std::string &suffix)
+  {
+    return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+  bool isInstanceFile(std::string name)
+  {
+    if (hasSuffix(name, ".gz")) name.resize(name.size() - 3);
+    return hasSuffix(name, ".mps") || hasSuffix(name, ".lp") || hasSuffix(name, ".cip");
+  }
+
+  double solveInstance(const std::string &instance, const SolverConfig &config, double timeLimit)
+  { // solving time, unsolved instances count twice the time limit
+    SCIP *scip = nullptr;
+    SCIP_CALL_EXC(SCIPcreate(&scip));
+    double time = 2.0 * timeLimit;
+    try
+    {
+      SCIP_CALL_EXC(SCIPincludeDefaultPlugins(scip));
+      SCIP_CALL_EXC(SCIPreadProb(scip, instance.c_str(), NULL));
+      applyConfig(scip, config);
+      SCIP_CALL_EXC(SCIPsetIntParam(scip, "display/verblevel", 0)); // after the config, which may reset it
+      SCIP_CALL_EXC(SCIPsetRealParam(scip, "limits/time", timeLimit));
+      SCIP_CALL_EXC(SCIPsolve(scip));
+      SCIP_STATUS status = SCIPgetStatus(scip);
+      if (status == SCIP_STATUS_OPTIMAL || status == SCIP_STATUS_INFEASIBLE) time = SCIPgetSolvingTime(scip);
+    }
+    catch (...)
+    {
+      SCIPfree(&scip);
+      throw;
+    }
+    SCIP_CALL_EXC(SCIPfree(&scip));
+    return time;
+  }
+
+  SolverConfig sampleConfig(const std::vector<TuningParameter> &space, const TuningOptions &options,
+                            fuint32_t index, std::mt19937 &random)
+  {
+    SolverConfig config{"candidate_" + std::to_string(index)};
+    if (index == 0) return config; // the default settings are always a candidate
+    config.emphasis = options.emphases.at(random() % options.emphases.size());
+    for (const auto &parameter : space)
+    {
+      if (parameter.values.empty()) continue;
+      config.setParameter(parameter.name, parameter.values.at(random() % parameter.values.size()));
+    }
+    return config;
+  }
+
+  struct Candidate
+  {
+    Candidate(const SolverConfig &_config)
+      : config(_config) {}
+
+    double getScore(fuint32_t nbInstances) const
+    { // shifted geometric mean over the first nbInstances instances
+      double logSum = 0.0;
+      for (fuint32_t i = 0; i < nbInstances; i++) logSum += std::log(times[i] + TIME_SHIFT);
+      return std::exp(logSum / nbInstances) - TIME_SHIFT;
+    }
+
+    public:
+      SolverConfig config;
+      std::vector<double> times; // solving times of the instances evaluated so far (in the shuffled order)
+  };
+}
+
+namespace scip_wrapper
+{
+  std::vector<std::string> findInstances(const std::string &directory)
+  {
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) throw std::invalid_argument("Cannot open directory " + directory + "...");
+    std::vector<std::string> instances{};
+    for (dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+    {
+      std::string name{entry->d_name};
+      if (isInstanceFile(name)) instances.push_back(directory + "/" + name);
+    }
+    closedir(dir);
+    std::sort(instances.begin(), instances.end());
+    return instances;
+  }
+
+  std::vector<TuningParameter> createDefaultTuningSpace()
+  {
+    return std::vector<TuningParameter>
+    {
+      TuningParameter{"separating/maxroundsroot", {-1, 5, 20}},
+      TuningParameter{"separating/gomory/freq", {-1, 0, 10}},
+      TuningParameter{"separating/aggregation/freq", {-1, 0, 10}},
+      TuningParameter{"separating/zerohalf/freq", {-1, 0, 10}},
+      TuningParameter{"heuristics/rins/freq", {-1, 10, 25}},
+      TuningParameter{"heuristics/rens/freq", {-1, 0}},
+      TuningParameter{"heuristics/feaspump/freq", {-1, 0, 20}},
+      TuningParameter{"heuristics/localbranching/freq", {-1, 10}},
+      TuningParameter{"presolving/maxrounds", {-1, 0, 5}},
+      TuningParameter{"presolving/maxrestarts", {-1, 0}}
+    };
+  }
+
+  TuningResult tuneParameters(const std::vector<std::string> &instances, const std::vector<TuningParameter> &space,
+                              const TuningOptions &options)
+  {
+    if (instances.empty()) throw std::invalid_argument("No instances to tune on...");
+    if (options.nbCandidates == 0 || options.emphases.empty()) throw std::invalid_argument("No candidates to tune...");
+
+    std::mt19937 random{options.seed};
+    std::vector<std::string> order = instances;
+    std::shuffle(order.begin(), order.end(), random);
+    std::vector<Candidate> candidates{};
+    for (fuint32_t i = 0; i < options.nbCandidates; i++) candidates.push_back(Candidate{sampleConfig(space, options, i, random)});
+
+    // the number of instances doubles with every halving such that the last round uses all of them
+    fuint32_t nbRounds = 0;
+    while ((1u << nbRounds) < candidates.size()) nbRounds++;
+    fuint32_t nbInstances = std::max<fuint32_t>(1, order.size() >> nbRounds);
+
+    WorkStealingPool pool{options.nbThreads};
+    fuint32_t nbRuns = 0;
+    while (true)
+    {
+      std::vector<std::pair<fuint32_t, fuint32_t>> runs{}; // (candidate, instance) not evaluated yet
+      for (fuint32_t c = 0; c < candidates.size(); c++)
+      {
+        candidates[c].times.resize(nbInstances, -1.0);
+        for (fuint32_t i = 0; i < nbInstances; i++)
+        {
+          if (candidates[c].times[i] < 0.0) runs.push_back(std::make_pair(c, i));
+        }
+      }
+      pool.run(runs.size(), [&](fuint32_t run)
+      { // every run writes a distinct entry
+        auto &candidate = candidates[runs[run].first];
+        candidate.times[runs[run].second] = solveInstance(order[runs[run].second], candidate.config, options.timeLimit);
+      });
+      nbRuns += runs.size();
+
+      std::stable_sort(candidates.begin(), candidates.end(), [&](const Candidate &a, const Candidate &b)
+      {
+        return a.getScore(nbInstances) < b.getScore(nbInstances);
+      });
+      if (candidates.size() == 1) break;
+      candidates.erase(candidates.begin() + (candidates.size() + 1) / 2, candidates.end());
+      nbInstances = std::min<fuint32_t>(order.size(), 2 * nbInstances);
+    }
+    return TuningResult{candidates.front().config, candidates.front().getScore(nbInstances), nbRuns};
+  }
+
+  void writeSettings(const SolverConfig &config, const std::string &path)
+  { // only parameters differing from the defaults are written (the emphasis is expanded to its parameters)
+    SCIP *scip = nullptr;
+    SCIP_CALL_EXC(SCIPcreate(&scip));
+    try
+    {
+      SCIP_CALL_EXC(SCIPincludeDefaultPlugins(scip));
+      applyConfig(scip, config);
+      SCIP_CALL_EXC(SCIPwriteParams(scip, path.c_str(), TRUE, TRUE));
+    }
+    catch (...)
+    {
+      SCIPfree(&scip);
+      throw;
+    }
+    SCIP_CALL_EXC(SCIPfree(&scip));
+  }
+}
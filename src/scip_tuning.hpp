@@ -0,0 +1,57 @@
+#ifndef SCIP_TUNING_HPP
+#define SCIP_TUNING_HPP
+
+#include "scip_wrapper.hpp"
+
+/*
+ * Offline tuning of SCIP parameters over a set of instance files (anything SCIPreadProb reads, e.g. .mps, .lp or .cip).
+ * Candidate configs are sampled from a parameter space and compared by successive halving.
+ */
+
+namespace scip_wrapper
+{
+  struct TuningParameter
+  { // a numerical SCIP parameter and the values tried for it
+    TuningParameter(const std::string &_name, const std::vector<double> &_values)
+      : name(_name), values(_values) {}
+
+    public:
+      std::string name;
+      std::vector<double> values;
+  };
+
+  struct TuningOptions
+  {
+    TuningOptions()
+      : nbCandidates(16), nbThreads(1), timeLimit(60.0), seed(0),
+        emphases{SCIP_PARAMEMPHASIS_DEFAULT, SCIP_PARAMEMPHASIS_EASYCIP, SCIP_PARAMEMPHASIS_FEASIBILITY,
+                 SCIP_PARAMEMPHASIS_OPTIMALITY, SCIP_PARAMEMPHASIS_HARDLP} {}
+
+    public:
+      fuint32_t nbCandidates; // including the default settings
+      fuint32_t nbThreads;
+      double timeLimit; // per run, unsolved runs count twice the time limit
+      fuint32_t seed;
+      std::vector<SCIP_PARAMEMPHASIS> emphases;
+  };
+
+  struct TuningResult
+  {
+    TuningResult(const SolverConfig &_config, double _score, fuint32_t _nbRuns)
+      : config(_config), score(_score), nbRuns(_nbRuns) {}
+
+    public:
+      SolverConfig config;
+      double score; // shifted geometric mean of the solving times
+      fuint32_t nbRuns;
+  };
+
+  std::vector<std::string> findInstances(const std::string &directory); // sorted paths of .mps, .lp and .cip files (also gzipped)
+  std::vector<TuningParameter> createDefaultTuningSpace(); // separator and heuristic frequencies, presolving rounds
+  // all candidates are solved on a few instances, the better half continues on twice as many instances
+  TuningResult tuneParameters(const std::vector<std::string> &instances, const std::vector<TuningParameter> &space,
+                              const TuningOptions &options = TuningOptions{});
+  void writeSettings(const SolverConfig &config, const std::string &path); // loadable using MILPSolver::loadSettings
+}
+
+#endif
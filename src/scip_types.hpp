@@ -0,0 +1,32 @@
+#ifndef SCIP_TYPES_HPP
+#define SCIP_TYPES_HPP
+
+#include <cinttypes>
+#include <limits>
+
+/*
+ * Types shared by the MILPSolver and the daemon client (see scip_client.hpp), the latter does not depend on SCIP.
+ */
+
+namespace scip_wrapper
+{
+  typedef uint_fast32_t fuint32_t;
+
+  const double INF_BOUND = std::numeric_limits<double>::infinity(); // side of a row that is not bounded
+
+  enum SolverSense
+  {
+    MINIMIZE = +1,
+    MAXIMIZE = -1
+  };
+
+  enum VariableType
+  {
+    BINARY,
+    INTEGER,
+    IMPLICIT_INTEGER,
+    CONTINUOUS
+  };
+}
+
+#endif
@@ -1,4 +1,13 @@
 #include "scip_wrapper.hpp"
+#include "scip_plugins.hpp"
+#include "scip_parallel.hpp"
+#include "scip_lp.hpp"
+#include "scip_network.hpp"
+#include "scip_snapshot.hpp"
+#include "scip_cache.hpp"
+#include "scip_builder.hpp"
+
+#include <zlib.h>
 
 // keksklauer4 16.03.2021
 
@@ -19,13 +28,15 @@ namespace scip_wrapper
       return SCIP_OBJSENSE_MINIMIZE;
     }
 
-    SCIP_Vartype getSCIPVarType(VariableType type)
+    ResultStatus toResultStatus(SCIP_STATUS status, bool found)
     {
-      #ifdef RELAX_PROBLEM
-      // for testing purposes a quick way to just relax all variables to continuous variables
-      return SCIP_Vartype::SCIP_VARTYPE_CONTINUOUS;
-      #endif
+      if (status == SCIP_STATUS_OPTIMAL && found) return RESULT_OPTIMAL;
+      if (status == SCIP_STATUS_INFEASIBLE && !found) return RESULT_INFEASIBLE;
+      return found ? RESULT_FEASIBLE : RESULT_UNKNOWN;
+    }
 
+    SCIP_Vartype getSCIPVarType(VariableType type)
+    {
       switch(type)
       {
         case VariableType::BINARY: return SCIP_Vartype::SCIP_VARTYPE_BINARY;
@@ -35,6 +46,177 @@ namespace scip_wrapper
       }
       return SCIP_Vartype::SCIP_VARTYPE_CONTINUOUS;
     }
+
+    VariableType getVariableType(SCIP_Vartype type)
+    {
+      switch(type)
+      {
+        case SCIP_Vartype::SCIP_VARTYPE_BINARY: return VariableType::BINARY;
+        case SCIP_Vartype::SCIP_VARTYPE_INTEGER: return VariableType::INTEGER;
+        case SCIP_Vartype::SCIP_VARTYPE_IMPLINT: return VariableType::IMPLICIT_INTEGER;
+        case SCIP_Vartype::SCIP_VARTYPE_CONTINUOUS: return VariableType::CONTINUOUS;
+      }
+      return VariableType::CONTINUOUS;
+    }
+
+    SCIP_BRANCHDIR getSCIPBranchDir(BranchDirection direction)
+    {
+      switch(direction)
+      {
+        case BranchDirection::BRANCH_DOWN: return SCIP_BRANCHDIR_DOWNWARDS;
+        case BranchDirection::BRANCH_UP: return SCIP_BRANCHDIR_UPWARDS;
+        case BranchDirection::BRANCH_AUTO: return SCIP_BRANCHDIR_AUTO;
+      }
+      return SCIP_BRANCHDIR_AUTO;
+    }
+
+    SCIP_ORBITOPETYPE getSCIPOrbitopeType(OrbitopeType type)
+    {
+      switch(type)
+      {
+        case OrbitopeType::FULL_ORBITOPE: return SCIP_ORBITOPETYPE_FULL;
+        case OrbitopeType::PARTITIONING_ORBITOPE: return SCIP_ORBITOPETYPE_PARTITIONING;
+        case OrbitopeType::PACKING_ORBITOPE: return SCIP_ORBITOPETYPE_PACKING;
+      }
+      return SCIP_ORBITOPETYPE_FULL;
+    }
+
+    bool isIntegral(double value)
+    {
+      return std::abs(value - std::round(value)) < 1e-9;
+    }
+
+    ssize_t writeCompressed(void *cookie, const char *data, size_t size)
+    {
+      if (size == 0) return 0;
+      int written = gzwrite(reinterpret_cast<gzFile>(cookie), data, size);
+      return written <= 0 ? -1 : written;
+    }
+
+    int closeCompressed(void *cookie)
+    {
+      return gzclose(reinterpret_cast<gzFile>(cookie)) == Z_OK ? 0 : -1;
+    }
+
+    FILE *openCompressed(const std::string &path)
+    { // stdio stream compressing on the fly, thus SCIP's writers can print to it
+      gzFile compressed = gzopen(path.c_str(), "wb");
+      if (compressed == nullptr) return nullptr;
+      cookie_io_functions_t functions{nullptr, writeCompressed, nullptr, closeCompressed};
+      FILE *file = fopencookie(compressed, "w", functions);
+      if (file == nullptr) gzclose(compressed);
+      return file;
+    }
+
+    double toSnapshotValue(SCIP *scip, double value)
+    { // snapshots do not depend on SCIP's infinity
+      if (SCIPisInfinity(scip, value)) return INF_BOUND;
+      if (SCIPisInfinity(scip, -value)) return -INF_BOUND;
+      return value;
+    }
+
+    double fromSnapshotValue(SCIP *scip, double value)
+    {
+      if (value == INF_BOUND) return SCIPinfinity(scip);
+      if (value == -INF_BOUND) return -SCIPinfinity(scip);
+      return value;
+    }
+
+    void addRowTerm(SCIP *scip, SCIP_VAR *var, double coefficient, LinearRow &row)
+    { // original variables are indexed in the order of the problem, negated ones have no index:
+      // coefficient * (1 - x) = coefficient - coefficient * x, thus both sides are shifted
+      if (SCIPvarIsNegated(var))
+      {
+        var = SCIPvarGetNegationVar(var);
+        if (!SCIPisInfinity(scip, -row.lhs)) row.lhs -= coefficient;
+        if (!SCIPisInfinity(scip, row.rhs)) row.rhs -= coefficient;
+        coefficient = -coefficient;
+      }
+      row.addVariable(SCIPvarGetProbindex(var), coefficient);
+    }
+
+    void addRowVars(SCIP *scip, SCIP_VAR **vars, int nbVars, LinearRow &row)
+    {
+      for (int i = 0; i < nbVars; i++) addRowTerm(scip, vars[i], 1.0, row);
+    }
+
+    bool readRow(SCIP *scip, SCIP_CONS *cons, LinearRow &row, RowKind &kind)
+    { // constraints of the handlers rows are upgraded to (returns false for other handlers)
+      const std::string handler{SCIPconshdlrGetName(SCIPconsGetHdlr(cons))};
+      if (handler == "linear")
+      {
+        kind = LINEAR_ROW;
+        row = LinearRow{SCIPgetLhsLinear(scip, cons), SCIPgetRhsLinear(scip, cons)};
+        SCIP_VAR **vars = SCIPgetVarsLinear(scip, cons);
+        SCIP_Real *values = SCIPgetValsLinear(scip, cons);
+        for (int i = 0; i < SCIPgetNVarsLinear(scip, cons); i++) addRowTerm(scip, vars[i], values[i], row);
+      }
+      else if (handler == "setppc")
+      {
+        kind = SETPPC_ROW;
+        switch (SCIPgetTypeSetppc(scip, cons))
+        {
+          case SCIP_SETPPCTYPE_PARTITIONING: row = LinearRow{1.0, 1.0}; break;
+          case SCIP_SETPPCTYPE_PACKING: row = LinearRow{-SCIPinfinity(scip), 1.0}; break;
+          case SCIP_SETPPCTYPE_COVERING: row = LinearRow{1.0, SCIPinfinity(scip)}; break;
+        }
+        addRowVars(scip, SCIPgetVarsSetppc(scip, cons), SCIPgetNVarsSetppc(scip, cons), row);
+      }
+      else if (handler == "logicor")
+      {
+        kind = LOGICOR_ROW;
+        row = LinearRow{1.0, SCIPinfinity(scip)};
+        addRowVars(scip, SCIPgetVarsLogicor(scip, cons), SCIPgetNVarsLogicor(scip, cons), row);
+      }
+      else if (handler == "knapsack")
+      {
+        kind = KNAPSACK_ROW;
+        row = LinearRow{-SCIPinfinity(scip), static_cast<double>(SCIPgetCapacityKnapsack(scip, cons))};
+        SCIP_VAR **vars = SCIPgetVarsKnapsack(scip, cons);
+        SCIP_Longint *weights = SCIPgetWeightsKnapsack(scip, cons);
+        for (int i = 0; i < SCIPgetNVarsKnapsack(scip, cons); i++)
+        {
+          addRowTerm(scip, vars[i], static_cast<double>(weights[i]), row);
+        }
+      }
+      else if (handler == "varbound")
+      {
+        kind = VARBOUND_ROW;
+        row = LinearRow{SCIPgetLhsVarbound(scip, cons), SCIPgetRhsVarbound(scip, cons)};
+        addRowTerm(scip, SCIPgetVarVarbound(scip, cons), 1.0, row);
+        addRowTerm(scip, SCIPgetVbdvarVarbound(scip, cons), SCIPgetVbdcoefVarbound(scip, cons), row);
+      }
+      else return false;
+      return true;
+    }
+
+    const char *getRowKindName(RowKind kind)
+    {
+      switch(kind)
+      {
+        case RowKind::LINEAR_ROW: return "linear";
+        case RowKind::SETPPC_ROW: return "setppc";
+        case RowKind::LOGICOR_ROW: return "logicor";
+        case RowKind::KNAPSACK_ROW: return "knapsack";
+        case RowKind::VARBOUND_ROW: return "varbound";
+        case RowKind::LAZY_ROW: return "lazy";
+        default: break;
+      }
+      return "";
+    }
+
+    void mergeTerms(QUBOTermVec &terms)
+    { // sums up duplicate cells so that each cell of Q is contained at most once
+      if (terms.empty()) return;
+      std::sort(terms.begin(), terms.end());
+      auto last = terms.begin();
+      for (auto it = terms.begin() + 1; it != terms.end(); ++it)
+      {
+        if (it->x == last->x && it->y == last->y) last->coefficient += it->coefficient;
+        else *(++last) = *it;
+      }
+      terms.erase(last + 1, terms.end());
+    }
   }
 
 template<>
@@ -57,8 +239,53 @@ void SCIPConstraint<true>::addQuadratic(SCIP *scip, SCIPVariable &var1, SCIPVari
 }
 
 
+std::vector<SolverConfig> createDefaultPortfolio(fuint32_t nbConfigs)
+{
+  std::vector<SolverConfig> configs
+  {
+    SolverConfig{"default"},
+    SolverConfig{"feasibility", SCIP_PARAMEMPHASIS_FEASIBILITY, SCIP_PARAMSETTING_FAST, SCIP_PARAMSETTING_AGGRESSIVE},
+    SolverConfig{"optimality", SCIP_PARAMEMPHASIS_OPTIMALITY, SCIP_PARAMSETTING_AGGRESSIVE},
+    SolverConfig{"aggressive_heuristics", SCIP_PARAMEMPHASIS_DEFAULT, SCIP_PARAMSETTING_DEFAULT, SCIP_PARAMSETTING_AGGRESSIVE},
+    SolverConfig{"easy_cip", SCIP_PARAMEMPHASIS_EASYCIP, SCIP_PARAMSETTING_FAST, SCIP_PARAMSETTING_FAST}
+  };
+  for (int seed = 1; configs.size() < nbConfigs; seed++)
+  {
+    configs.push_back(SolverConfig{"seed_" + std::to_string(seed), SCIP_PARAMEMPHASIS_DEFAULT,
+                                   SCIP_PARAMSETTING_DEFAULT, SCIP_PARAMSETTING_DEFAULT, seed});
+  }
+  if (configs.size() > nbConfigs) configs.erase(configs.begin() + nbConfigs, configs.end());
+  return configs;
+}
+
+fuint32_t PortfolioStatistics::getWins(const std::string &name) const
+{
+  auto it = wins.find(name);
+  return it == wins.end() ? 0 : it->second;
+}
+
+std::vector<SolverConfig> PortfolioStatistics::prune(const std::vector<SolverConfig> &configs, fuint32_t nbKept) const
+{
+  std::vector<SolverConfig> kept = configs;
+  std::stable_sort(kept.begin(), kept.end(), [&](const SolverConfig &a, const SolverConfig &b)
+  {
+    return getWins(a.name) > getWins(b.name);
+  });
+  if (kept.size() > nbKept) kept.erase(kept.begin() + nbKept, kept.end());
+  return kept;
+}
+
+void PortfolioStatistics::print(std::ostream &os) const
+{
+  os << nbRaces << " races" << std::endl;
+  for (const auto &config : wins) os << config.first << ": " << config.second << " wins" << std::endl;
+}
+
 MILPSolver::MILPSolver(std::string name, SolverSense sense)
-  : m_name(name)
+  : m_solution(nullptr), m_ownsSolution(false), m_nbCommittedRows(0), m_upgradeRows(true), m_rowStatistics{},
+    m_defaultBranchPriority(0), m_defaultBranchDirection(BRANCH_AUTO), m_bendersCreated(false), m_lpFastPath(false),
+    m_networkFastPath(false), m_cache(nullptr), m_resultStatus(RESULT_UNKNOWN),
+    m_name(name)
 {
   SCIP_CALL_EXC(SCIPcreate(&m_scip_model));
   SCIP_CALL_EXC(SCIPincludeDefaultPlugins(m_scip_model));
@@ -71,15 +298,8 @@ MILPSolver::~MILPSolver()
   try
   {
     if (m_scip_model == nullptr) return;
-
-    for (auto it = m_variables.begin(); it != m_variables.end(); ++it)
-    {
-      SCIP_CALL_EXC(SCIPreleaseVar(m_scip_model, &it->variable));
-    }
-    for (auto it = m_csts.begin(); it != m_csts.end(); ++it)
-    {
-      SCIP_CALL_EXC(SCIPreleaseCons(m_scip_model, &it->constraint));
-    }
+    freeSolution();
+    releaseModel();
     SCIP_CALL_EXC(SCIPfree(&m_scip_model));
   }
   catch(const std::exception& e)
@@ -89,13 +309,468 @@ MILPSolver::~MILPSolver()
   }
 }
 
+void MILPSolver::releaseModel()
+{
+  for (auto it = m_variables.begin(); it != m_variables.end(); ++it)
+  {
+    SCIP_CALL_EXC(SCIPreleaseVar(m_scip_model, &it->variable));
+  }
+  for (auto it = m_csts.begin(); it != m_csts.end(); ++it)
+  {
+    if (it->constraint == nullptr) continue; // never committed
+    SCIP_CALL_EXC(SCIPreleaseCons(m_scip_model, &it->constraint));
+  }
+  for (auto it = m_specialCsts.begin(); it != m_specialCsts.end(); ++it)
+  {
+    SCIP_CALL_EXC(SCIPreleaseCons(m_scip_model, &(*it)));
+  }
+  m_variables.clear();
+  m_csts.clear();
+  m_specialCsts.clear();
+}
+
+bool MILPSolver::hasOnlyLinearRows() const
+{ // no other constraints than linear rows and nothing the user plugins could add
+  if (!m_specialCsts.empty() || !m_lazyRows.empty() || !m_bendersSubproblems.empty()) return false;
+  return m_lazyHandlers.empty() && m_separators.empty() && m_heuristics.empty() && m_branchingRules.empty() && m_pricers.empty();
+}
+
+bool MILPSolver::isPureLP() const
+{
+  if (!hasOnlyLinearRows()) return false;
+  for (const auto &var : m_variables)
+  {
+    if (SCIPvarGetType(var.variable) != SCIP_VARTYPE_CONTINUOUS) return false;
+  }
+  return true;
+}
+
+bool MILPSolver::solveNetwork()
+{ // returns false if the model is no network flow problem
+  if (!hasOnlyLinearRows()) return false;
+  std::unique_ptr<NetworkSimplex> network = createNetwork(m_scip_model, m_variables, m_rows);
+  if (network == nullptr) return false;
+  resetTransform();
+  freeSolution();
+  NetworkStatus status = network->solve();
+  if (status == NETWORK_OPTIMAL)
+  {
+    getNetworkSolution(m_scip_model, *network, m_lpSolution);
+    storeSolution(m_lpSolution.values);
+  }
+  m_resultStatus = status == NETWORK_OPTIMAL ? RESULT_OPTIMAL : status == NETWORK_INFEASIBLE ? RESULT_INFEASIBLE : RESULT_UNKNOWN;
+  return true;
+}
+
 bool MILPSolver::solve()
+{ // proven results (optimal or infeasible) of models made of variables and rows only are cached
+  const bool cacheable = m_cache != nullptr && hasOnlyLinearRows();
+  ModelKey key{};
+  CachedSolution cached{};
+  if (cacheable)
+  {
+    key = getModelKey();
+    if (m_cache->lookup(key, cached) && cached.values.size() == (cached.feasible ? m_variables.size() : 0))
+    {
+      resetTransform();
+      if (cached.feasible) storeSolution(cached.values);
+      m_resultStatus = cached.feasible ? RESULT_OPTIMAL : RESULT_INFEASIBLE;
+      return m_solution != nullptr;
+    }
+  }
+
+  bool found = solveModel();
+  if (!cacheable) return found;
+  if (m_resultStatus == RESULT_OPTIMAL)
+  {
+    std::vector<SCIP_VAR*> scipVars{};
+    for (const auto &var : m_variables) scipVars.push_back(var.variable);
+    cached.feasible = true;
+    cached.objective = SCIPgetSolOrigObj(m_scip_model, m_solution);
+    cached.values.resize(scipVars.size());
+    SCIP_CALL_EXC(SCIPgetSolVals(m_scip_model, m_solution, scipVars.size(), scipVars.data(), cached.values.data()));
+    m_cache->store(key, cached);
+  }
+  else if (m_resultStatus == RESULT_INFEASIBLE)
+  {
+    cached = CachedSolution{};
+    m_cache->store(key, cached);
+  }
+  return found;
+}
+
+bool MILPSolver::solveModel()
 {
+  if (m_networkFastPath && solveNetwork()) return m_solution != nullptr;
+  if (m_lpFastPath && isPureLP())
+  { // the LP solver is called directly, skipping presolving and the tree
+    resetTransform();
+    bool optimal = solveLP(m_scip_model, m_variables, m_rows, m_lpSolution);
+    if (optimal) storeSolution(m_lpSolution.values);
+    m_resultStatus = optimal ? RESULT_OPTIMAL : m_lpSolution.infeasible ? RESULT_INFEASIBLE : RESULT_UNKNOWN;
+    return m_solution != nullptr;
+  }
+
+  freeSolution();
+  commitRows();
+  if (!m_bendersSubproblems.empty() && !m_bendersCreated) createBenders();
   SCIP_CALL_EXC(SCIPsolve(m_scip_model));
   m_solution = SCIPgetBestSol(m_scip_model);
+  m_resultStatus = toResultStatus(SCIPgetStatus(m_scip_model), m_solution != nullptr);
+  return m_solution != nullptr;
+}
+
+bool MILPSolver::solveRelaxation(LPSolution &solution)
+{
+  return solveLP(m_scip_model, m_variables, m_rows, solution);
+}
+
+bool MILPSolver::solveDecomposed(fuint32_t nbThreads, VariableSpan splitVars)
+{
+  if (nbThreads == 0) throw std::invalid_argument("At least one thread is needed...");
+  if (!m_lazyHandlers.empty() || !m_heuristics.empty() || !m_branchingRules.empty() || !m_pricers.empty()
+      || !m_bendersSubproblems.empty())
+  { // the copies hold the problem only, without the callbacks they would solve a different model
+    throw std::logic_error("Models with plugins cannot be solved decomposed...");
+  }
+  commitRows();
+  resetTransform();
+
+  std::vector<fuint32_t> vars{splitVars.begin(), splitVars.end()};
+  if (vars.empty())
+  { // about four subproblems per thread
+    fuint32_t nbSplits = 1;
+    while ((1u << nbSplits) < 4 * nbThreads) nbSplits++;
+    vars = chooseSplitVariables(m_variables, nbSplits);
+  }
+  if (vars.size() > 20) throw std::invalid_argument("Too many split variables...");
+  for (auto var : vars)
+  {
+    if (var >= m_variables.size()) throw std::range_error("Variable index out of range...");
+    if (SCIPvarGetType(m_variables[var].variable) != SCIP_VARTYPE_BINARY) throw std::invalid_argument("Split variables must be binary...");
+  }
+
+  SharedIncumbent incumbent{SCIPgetObjsense(m_scip_model)};
+  std::mutex bestMutex;
+  std::atomic<bool> allProven{true}; // every subproblem solved to optimality or cut off
+  double bestObjective = 0.0;
+  std::vector<double> bestValues{};
+  WorkStealingPool pool{nbThreads};
+  pool.run(1u << vars.size(), [&](fuint32_t subproblem)
+  { // the bits of the subproblem index are the values of the split variables
+    ModelCopy copy{};
+    copyModel(m_scip_model, m_variables, copy, "_" + std::to_string(subproblem));
+    for (fuint32_t i = 0; i < vars.size(); i++)
+    {
+      double value = (subproblem >> i) & 1u;
+      SCIP_CALL_EXC(SCIPchgVarLb(copy.scip, copy.vars[vars[i]], value));
+      SCIP_CALL_EXC(SCIPchgVarUb(copy.scip, copy.vars[vars[i]], value));
+    }
+    includeIncumbentSharing(copy.scip, &incumbent);
+    double limit = incumbent.get();
+    if (std::isfinite(limit)) SCIP_CALL_EXC(SCIPsetObjlimit(copy.scip, limit));
+    SCIP_CALL_EXC(SCIPsolve(copy.scip));
+    SCIP_STATUS status = SCIPgetStatus(copy.scip);
+    if (status != SCIP_STATUS_OPTIMAL && status != SCIP_STATUS_INFEASIBLE) allProven.store(false);
+
+    SCIP_SOL *sol = SCIPgetBestSol(copy.scip);
+    if (sol == nullptr) return;
+    double objective = SCIPgetSolOrigObj(copy.scip, sol);
+    std::lock_guard<std::mutex> lock(bestMutex);
+    if (!bestValues.empty() && !incumbent.isBetter(objective, bestObjective)) return;
+    bestObjective = objective;
+    bestValues.resize(copy.vars.size());
+    SCIP_CALL_EXC(SCIPgetSolVals(copy.scip, sol, copy.vars.size(), copy.vars.data(), bestValues.data()));
+  });
+  if (!bestValues.empty()) storeSolution(bestValues);
+  if (allProven.load()) m_resultStatus = bestValues.empty() ? RESULT_INFEASIBLE : RESULT_OPTIMAL;
+  else m_resultStatus = bestValues.empty() ? RESULT_UNKNOWN : RESULT_FEASIBLE;
+  return m_solution != nullptr;
+}
+
+bool MILPSolver::solvePortfolio(const std::vector<SolverConfig> &configs, fuint32_t nbThreads, PortfolioStatistics *statistics)
+{
+  if (configs.empty()) throw std::invalid_argument("Portfolio is empty...");
+  if (nbThreads == 0) throw std::invalid_argument("At least one thread is needed...");
+  if (!m_lazyHandlers.empty() || !m_heuristics.empty() || !m_branchingRules.empty() || !m_pricers.empty()
+      || !m_bendersSubproblems.empty())
+  { // as for solveDecomposed, the copies would lack the callbacks
+    throw std::logic_error("Models with plugins cannot be solved by a portfolio...");
+  }
+  commitRows();
+  resetTransform();
+
+  std::atomic<bool> finished{false};
+  std::mutex bestMutex;
+  fuint32_t winner = configs.size();
+  SharedIncumbent incumbent{SCIPgetObjsense(m_scip_model)};
+  double bestObjective = 0.0;
+  std::vector<double> bestValues{};
+  WorkStealingPool pool{std::min<fuint32_t>(nbThreads, configs.size())};
+  pool.run(configs.size(), [&](fuint32_t index)
+  {
+    if (finished.load()) return; // configs waiting for a thread are not started once another config won
+    ModelCopy copy{};
+    copyModel(m_scip_model, m_variables, copy, "_" + configs[index].name);
+    applyConfig(copy.scip, configs[index]);
+    includeInterruption(copy.scip, &finished);
+    SCIP_CALL_EXC(SCIPsolve(copy.scip));
+
+    SCIP_STATUS status = SCIPgetStatus(copy.scip);
+    bool proven = status == SCIP_STATUS_OPTIMAL || status == SCIP_STATUS_INFEASIBLE;
+    SCIP_SOL *sol = SCIPgetBestSol(copy.scip);
+    std::lock_guard<std::mutex> lock(bestMutex);
+    if (winner < configs.size()) return;
+    if (proven)
+    {
+      winner = index;
+      finished.store(true);
+      bestValues.clear();
+    }
+    if (sol == nullptr) return;
+    // without a winner (e.g. all configs hit a limit) the best solution found is kept
+    double objective = SCIPgetSolOrigObj(copy.scip, sol);
+    if (!proven && !bestValues.empty() && !incumbent.isBetter(objective, bestObjective)) return;
+    bestObjective = objective;
+    bestValues.resize(copy.vars.size());
+    SCIP_CALL_EXC(SCIPgetSolVals(copy.scip, sol, copy.vars.size(), copy.vars.data(), bestValues.data()));
+  });
+
+  if (statistics != nullptr)
+  {
+    statistics->nbRaces++;
+    if (winner < configs.size()) statistics->wins[configs[winner].name]++;
+  }
+  if (!bestValues.empty()) storeSolution(bestValues);
+  if (winner < configs.size()) m_resultStatus = bestValues.empty() ? RESULT_INFEASIBLE : RESULT_OPTIMAL;
+  else m_resultStatus = bestValues.empty() ? RESULT_UNKNOWN : RESULT_FEASIBLE;
   return m_solution != nullptr;
 }
 
+void MILPSolver::storeSolution(const std::vector<double> &values)
+{ // solution of a copy or the LP solver, owned by the wrapper (stale solutions would stay in SCIP's solution storage)
+  freeSolution();
+  std::vector<SCIP_VAR*> scipVars{};
+  for (const auto &var : m_variables) scipVars.push_back(var.variable);
+  SCIP_CALL_EXC(SCIPcreateOrigSol(m_scip_model, &m_solution, NULL));
+  m_ownsSolution = true;
+  SCIP_CALL_EXC(SCIPsetSolVals(m_scip_model, m_solution, scipVars.size(), scipVars.data(), const_cast<double*>(values.data())));
+}
+
+void MILPSolver::freeSolution()
+{
+  if (m_ownsSolution)
+  {
+    m_ownsSolution = false;
+    SCIP_CALL_EXC(SCIPfreeSol(m_scip_model, &m_solution));
+  }
+  m_solution = nullptr;
+  m_resultStatus = RESULT_UNKNOWN;
+}
+
+void MILPSolver::write(const std::string &path, const std::string &format)
+{ // lazy rows only live in the lazy row pool, they are written as ordinary rows (added to the original problem meanwhile)
+  commitRows();
+  if (m_lazyRows.empty())
+  {
+    writeOrigProblem(path, format);
+    return;
+  }
+  resetTransform();
+  std::vector<SCIP_CONS*> lazyConss{};
+  auto removeLazyConss = [&]()
+  {
+    for (auto &cons : lazyConss)
+    {
+      if (SCIPconsIsAdded(cons)) SCIP_CALL_EXC(SCIPdelCons(m_scip_model, cons));
+      SCIP_CALL_EXC(SCIPreleaseCons(m_scip_model, &cons));
+    }
+  };
+  try
+  {
+    std::vector<SCIP_VAR*> vars{};
+    std::vector<double> coefficients{};
+    for (auto index : m_lazyRows)
+    {
+      const auto nameIt = m_rowNames.find(index);
+      const char *name = nameIt == m_rowNames.end() ? "" : nameIt->second.c_str();
+      collectRow(m_rows[index], vars, coefficients, 1.0);
+      lazyConss.push_back(nullptr);
+      SCIP_CALL_EXC(SCIPcreateConsBasicLinear(m_scip_model, &lazyConss.back(), name, vars.size(), vars.data(),
+                                              coefficients.data(), m_rows[index].lhs, m_rows[index].rhs));
+      SCIP_CALL_EXC(SCIPaddCons(m_scip_model, lazyConss.back()));
+    }
+    writeOrigProblem(path, format);
+  }
+  catch (...)
+  {
+    if (!lazyConss.empty() && lazyConss.back() == nullptr) lazyConss.pop_back();
+    removeLazyConss();
+    throw;
+  }
+  removeLazyConss();
+}
+
+void MILPSolver::writeOrigProblem(const std::string &path, const std::string &format)
+{ // SCIP cannot write compressed files itself, thus gzipped output is streamed through zlib
+  std::string name = path;
+  bool compressed = name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0;
+  if (!compressed)
+  {
+    SCIP_CALL_EXC(SCIPwriteOrigProblem(m_scip_model, path.c_str(), format.empty() ? NULL : format.c_str(), FALSE));
+    return;
+  }
+
+  name.resize(name.size() - 3);
+  std::string extension = format;
+  if (extension.empty() && name.find_last_of('.') != std::string::npos) extension = name.substr(name.find_last_of('.') + 1);
+  if (extension.empty()) throw std::invalid_argument("File format of " + path + " is unknown...");
+  FILE *file = openCompressed(path);
+  if (file == nullptr) throw std::runtime_error("Cannot open " + path + "...");
+  std::vector<char> buffer(1 << 20);
+  std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+  SCIP_RETCODE printed = SCIPprintOrigProblem(m_scip_model, file, extension.c_str(), FALSE);
+  bool closed = std::fclose(file) == 0;
+  if (printed != SCIP_OKAY) throw SCIPException(printed);
+  if (!closed) throw std::runtime_error("Error while writing " + path + "...");
+}
+
+void MILPSolver::clearModel()
+{ // an empty problem keeping the parameters, used before a model is loaded
+  if (!m_lazyHandlers.empty() || !m_lazyRows.empty() || !m_separators.empty() || !m_heuristics.empty()
+      || !m_branchingRules.empty() || !m_pricers.empty() || !m_bendersSubproblems.empty())
+  {
+    throw std::logic_error("Models cannot be loaded once plugins refer to the variables...");
+  }
+  resetTransform();
+  releaseModel();
+  m_rows.clear();
+  m_rowNames.clear();
+  m_nbCommittedRows = 0;
+  m_rowStatistics.fill(0);
+  m_modelHash = ModelHash{};
+  SCIP_OBJSENSE sense = SCIPgetObjsense(m_scip_model);
+  SCIP_CALL_EXC(SCIPfreeProb(m_scip_model));
+  SCIP_CALL_EXC(SCIPcreateProb(m_scip_model, m_name.c_str(), NULL, NULL, NULL, NULL, NULL, NULL, NULL));
+  SCIP_CALL_EXC(SCIPsetObjsense(m_scip_model, sense));
+}
+
+void MILPSolver::read(const std::string &path)
+{
+  clearModel();
+  SCIP_CALL_EXC(SCIPreadProb(m_scip_model, path.c_str(), NULL));
+
+  SCIP_VAR **vars = SCIPgetOrigVars(m_scip_model);
+  m_variables.reserve(SCIPgetNOrigVars(m_scip_model));
+  for (int i = 0; i < SCIPgetNOrigVars(m_scip_model); i++)
+  { // captured like created variables, thus releaseModel() stays valid
+    SCIP_CALL_EXC(SCIPcaptureVar(m_scip_model, vars[i]));
+    m_variables.push_back(SCIPVariable{vars[i]});
+  }
+
+  // rows are committed already, constraints of other handlers (e.g. indicators) cannot be indexed
+  SCIP_CONS **conss = SCIPgetOrigConss(m_scip_model);
+  for (int i = 0; i < SCIPgetNOrigConss(m_scip_model); i++)
+  {
+    SCIP_CALL_EXC(SCIPcaptureCons(m_scip_model, conss[i]));
+    LinearRow row{0.0, 0.0};
+    RowKind kind = LINEAR_ROW;
+    if (!readRow(m_scip_model, conss[i], row, kind))
+    {
+      m_specialCsts.push_back(conss[i]);
+      continue;
+    }
+    m_csts.push_back(SCIPLinearConstraint{conss[i]});
+    m_rows.push_back(row);
+    m_rowStatistics[kind]++;
+  }
+  m_nbCommittedRows = m_rows.size();
+  rehashModel();
+}
+
+void MILPSolver::rehashModel()
+{ // for models not built through the wrapper's methods
+  m_modelHash = ModelHash{};
+  for (const auto &var : m_variables)
+  {
+    m_modelHash.addColumn(getVariableType(SCIPvarGetType(var.variable)), SCIPvarGetLbOriginal(var.variable),
+                          SCIPvarGetUbOriginal(var.variable), SCIPvarGetObj(var.variable));
+  }
+  for (fuint32_t r = 0; r < m_rows.size(); r++)
+  {
+    m_modelHash.addRow(m_rows[r].lhs, m_rows[r].rhs);
+    for (fuint32_t i = 0; i < m_rows[r].vars.size(); i++) m_modelHash.addNonzero(r, m_rows[r].vars[i], m_rows[r].coefficients[i]);
+  }
+}
+
+void MILPSolver::writeSnapshot(const std::string &path)
+{
+  if (!m_specialCsts.empty() || !m_pricedRows.empty()) throw std::logic_error("Snapshots only hold variables and linear rows...");
+  if (m_variables.size() > std::numeric_limits<uint32_t>::max()) throw std::range_error("Too many variables for a snapshot...");
+  SnapshotHeader header{};
+  header.sense = SCIPgetObjsense(m_scip_model);
+  header.nbVars = m_variables.size();
+  header.nbRows = m_rows.size();
+  for (const auto &row : m_rows) header.nbNonzeros += row.vars.size();
+
+  SnapshotWriter writer{path, header};
+  for (const auto &var : m_variables) writer.write(toSnapshotValue(m_scip_model, SCIPvarGetLbOriginal(var.variable)));
+  for (const auto &var : m_variables) writer.write(toSnapshotValue(m_scip_model, SCIPvarGetUbOriginal(var.variable)));
+  for (const auto &var : m_variables) writer.write(SCIPvarGetObj(var.variable));
+  for (const auto &var : m_variables) writer.write(static_cast<uint8_t>(getVariableType(SCIPvarGetType(var.variable))));
+  writer.endSection();
+  for (const auto &row : m_rows) writer.write(toSnapshotValue(m_scip_model, row.lhs));
+  for (const auto &row : m_rows) writer.write(toSnapshotValue(m_scip_model, row.rhs));
+  for (fuint32_t i = 0; i < m_rows.size(); i++) writer.write(m_lazyRows.count(i) != 0 ? SNAPSHOT_LAZY_ROW : SNAPSHOT_ROW);
+  writer.endSection();
+  uint64_t start = 0;
+  writer.write(start);
+  for (const auto &row : m_rows) writer.write(start += row.vars.size());
+  for (const auto &row : m_rows)
+  {
+    for (auto var : row.vars) writer.write(static_cast<uint32_t>(var));
+  }
+  writer.endSection();
+  for (const auto &row : m_rows) writer.write(reinterpret_cast<const char*>(row.coefficients.data()), row.coefficients.size() * sizeof(double));
+  writer.finish();
+}
+
+void MILPSolver::readSnapshot(const std::string &path)
+{ // rows are staged as if created by hand and committed (and upgraded) on solve()
+  MappedSnapshot snapshot{path};
+  const SnapshotHeader &header = snapshot.getHeader();
+  const SnapshotView &view = snapshot.getView();
+  // the whole snapshot is checked before the current model is dropped
+  if (std::any_of(view.types, view.types + header.nbVars, [](uint8_t type) { return type > CONTINUOUS; }))
+  {
+    throw std::runtime_error("Variable types of " + path + " are corrupted...");
+  }
+  if (view.rowStarts[0] != 0 || view.rowStarts[header.nbRows] != header.nbNonzeros
+      || !std::is_sorted(view.rowStarts, view.rowStarts + header.nbRows + 1)
+      || std::any_of(view.vars, view.vars + header.nbNonzeros, [&](uint32_t var) { return var >= header.nbVars; }))
+  {
+    throw std::runtime_error("Rows of " + path + " are corrupted...");
+  }
+  clearModel();
+  SCIP_CALL_EXC(SCIPsetObjsense(m_scip_model, static_cast<SCIP_OBJSENSE>(header.sense)));
+  setNbVars(header.nbVars);
+  setNbCsts(header.nbRows);
+  for (uint64_t i = 0; i < header.nbVars; i++)
+  {
+    createVar(static_cast<VariableType>(view.types[i]), fromSnapshotValue(m_scip_model, view.lowerBounds[i]),
+              fromSnapshotValue(m_scip_model, view.upperBounds[i]), view.objective[i]);
+  }
+  for (uint64_t r = 0; r < header.nbRows; r++)
+  {
+    fuint32_t index = createLinearConstraint(fromSnapshotValue(m_scip_model, view.lhs[r]), fromSnapshotValue(m_scip_model, view.rhs[r]));
+    LinearRow &row = m_rows.back();
+    row.vars.assign(view.vars + view.rowStarts[r], view.vars + view.rowStarts[r + 1]);
+    row.coefficients.assign(view.coefficients + view.rowStarts[r], view.coefficients + view.rowStarts[r + 1]);
+    if (view.kinds[r] == SNAPSHOT_LAZY_ROW) setLazy(index);
+  }
+  rehashModel();
+}
+
 void MILPSolver::setNbVars(fuint32_t nb)
 {
   if (m_variables.size() < nb) m_variables.reserve(nb);
@@ -104,6 +779,7 @@ void MILPSolver::setNbVars(fuint32_t nb)
 void MILPSolver::setNbCsts(fuint32_t nb)
 {
   if (m_csts.size() < nb) m_csts.reserve(nb);
+  if (m_rows.size() < nb) m_rows.reserve(nb);
 }
 
 double MILPSolver::getVariableValue(fuint32_t variableIndex)
@@ -125,6 +801,11 @@ fuint32_t MILPSolver::createVar(VariableType type, double lower_bound, double up
       lower_bound, upper_bound, objective_coefficient, getSCIPVarType(type), TRUE, FALSE,NULL, NULL, NULL, NULL, NULL));
 
   SCIP_CALL_EXC(SCIPaddVar(m_scip_model, m_variables.back().variable));
+  m_modelHash.addColumn(type, lower_bound, upper_bound, objective_coefficient);
+  if (m_defaultBranchPriority != 0 || m_defaultBranchDirection != BRANCH_AUTO)
+  {
+    setBranching(m_variables.size() - 1, m_defaultBranchPriority, m_defaultBranchDirection);
+  }
   return m_variables.size() - 1;
 }
 
@@ -160,11 +841,11 @@ fuint32_t MILPSolver::createIntVarLowerBounded(double lower_bound, double object
 }
 
 fuint32_t MILPSolver::createLinearConstraint(double lhs, double rhs, const char* name)
-{
-  m_csts.push_back(SCIPLinearConstraint{});
-  SCIP_CALL_EXC(SCIPcreateConsLinear(m_scip_model, &m_csts.back().constraint, name,
-    0, NULL, NULL, lhs, rhs, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE));
-  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_csts.back().constraint));
+{ // only staged, the SCIP constraint is created in commitRows()
+  m_csts.push_back(SCIPLinearConstraint{nullptr});
+  m_rows.push_back(LinearRow{lhs, rhs});
+  m_modelHash.addRow(lhs, rhs);
+  if (name != nullptr && name[0] != '\0') m_rowNames.insert(std::make_pair(m_rows.size() - 1, std::string{name}));
   return m_csts.size() - 1;
 }
 
@@ -185,72 +866,725 @@ fuint32_t MILPSolver::createLinearConstraintEq(double equalVal, const char* name
 }
 
 
-void MILPSolver::createUnequalConstraint(fuint32_t x1, fuint32_t x2, double largeNb)
+fuint32_t MILPSolver::createUnequalConstraint(fuint32_t x1, fuint32_t x2)
 { // only for integer/binary values
-  // two constraints and one binary variable
+  // y = 1 => x1 - x2 >= 1 and y = 0 => x1 - x2 <= -1
   fuint32_t yVar = createBinaryVar(0.0);
-  fuint32_t constraint1 = createLinearConstraintGeq(1.0);
-  addToCst(constraint1, x1, 1.0);
-  addToCst(constraint1, x2, -1.0);
-  addToCst(constraint1, yVar, largeNb);
-
-  fuint32_t constraint2 = createLinearConstraintLeq(largeNb - 1.0);
-  addToCst(constraint2, x1, 1.0);
-  addToCst(constraint2, x2, -1.0);
-  addToCst(constraint2, yVar, largeNb);
+  LinearRow greater{1.0, INF_BOUND};
+  greater.addVariable(x1, 1.0);
+  greater.addVariable(x2, -1.0);
+  createIndicatorConstraint(yVar, true, greater);
+
+  LinearRow smaller{-INF_BOUND, -1.0};
+  smaller.addVariable(x1, 1.0);
+  smaller.addVariable(x2, -1.0);
+  createIndicatorConstraint(yVar, false, smaller);
+  return yVar;
 }
 
-void MILPSolver::addToCst(fuint32_t cstIndex, fuint32_t varIndex, double coefficient)
-{
-  if (m_csts.size() <= cstIndex || varIndex >= m_variables.size())
-    throw std::range_error("Out of range in adding to constraint...");
+void MILPSolver::createIndicatorConstraint(fuint32_t binVar, bool activeValue, const LinearRow &row, const char *name)
+{ // binVar == activeValue => lhs <= row <= rhs (SCIP's indicator constraints only know a rhs)
+  if (binVar >= m_variables.size()) throw std::range_error("Variable index out of range...");
+  SCIP_VAR *indicatorVar = m_variables.at(binVar).variable;
+  if (!activeValue)
+  {
+    SCIP_CALL_EXC(SCIPgetNegatedVar(m_scip_model, indicatorVar, &indicatorVar));
+  }
 
-  m_csts.at(cstIndex).addVariable(m_scip_model, m_variables.at(varIndex), coefficient);
+  std::vector<SCIP_VAR*> vars{};
+  std::vector<double> coefficients{};
+  if (!SCIPisInfinity(m_scip_model, row.rhs))
+  {
+    collectRow(row, vars, coefficients, 1.0);
+    m_specialCsts.push_back(nullptr);
+    SCIP_CALL_EXC(SCIPcreateConsBasicIndicator(m_scip_model, &m_specialCsts.back(), name, indicatorVar,
+      vars.size(), vars.data(), coefficients.data(), row.rhs));
+    SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_specialCsts.back()));
+  }
+  if (!SCIPisInfinity(m_scip_model, -row.lhs))
+  {
+    collectRow(row, vars, coefficients, -1.0);
+    m_specialCsts.push_back(nullptr);
+    SCIP_CALL_EXC(SCIPcreateConsBasicIndicator(m_scip_model, &m_specialCsts.back(), name, indicatorVar,
+      vars.size(), vars.data(), coefficients.data(), -row.lhs));
+    SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_specialCsts.back()));
+  }
 }
 
+void MILPSolver::disableAutomaticSymmetry()
+{ // SCIP's own symmetry handling may pick a different representative than the user's constraints
+  SCIP_CALL_EXC(SCIPsetIntParam(m_scip_model, "misc/usesymmetry", 0));
+}
 
-/* ------------------------ QUBOSolver ------------------------ */
-
-QUBOSolver::QUBOSolver(SolverSense sense, double penalty)
-  : m_penalty(penalty), m_sense(sense), m_solution(nullptr)
+void MILPSolver::createOrbitope(const std::vector<std::vector<fuint32_t>> &matrix, OrbitopeType type, const char *name)
 {
-  SCIP_CALL_EXC(SCIPcreate(&m_scip_model));
-  SCIP_CALL_EXC(SCIPincludeDefaultPlugins(m_scip_model));
-  SCIP_CALL_EXC(SCIPcreateProb(m_scip_model, "", NULL, NULL,NULL, NULL, NULL, NULL, NULL));
-  SCIP_CALL_EXC(SCIPsetObjsense(m_scip_model, getSCIPObjSense(sense)));
+  if (matrix.empty() || matrix.front().empty()) throw std::invalid_argument("Orbitope matrix is empty...");
+  std::vector<std::vector<SCIP_VAR*>> scipVars{};
+  std::vector<SCIP_VAR**> rows{};
+  for (const auto &row : matrix)
+  {
+    if (row.size() != matrix.front().size()) throw std::invalid_argument("Orbitope rows differ in size...");
+    scipVars.push_back(collectVars(VariableSpan{row}));
+    for (auto var : scipVars.back())
+    {
+      if (SCIPvarGetType(var) != SCIP_VARTYPE_BINARY) throw std::invalid_argument("Orbitopes need binary variables...");
+    }
+  }
+  for (auto &row : scipVars) rows.push_back(row.data());
 
-  // create optimization variable
-  SCIP_CALL_EXC(SCIPcreateVar(m_scip_model, &m_targetVar.variable, "target",
-      NEG_INF, INF, 1.0, getSCIPVarType(CONTINUOUS), TRUE, FALSE,NULL, NULL, NULL, NULL, NULL));
-  SCIP_CALL_EXC(SCIPaddVar(m_scip_model, m_targetVar.variable));
+  disableAutomaticSymmetry();
+  m_specialCsts.push_back(nullptr);
+  SCIP_CALL_EXC(SCIPcreateConsBasicOrbitope(m_scip_model, &m_specialCsts.back(), name, rows.data(), getSCIPOrbitopeType(type),
+    matrix.size(), matrix.front().size(), FALSE, TRUE, TRUE, FALSE));
+  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_specialCsts.back()));
+}
 
-  // create constraint for optimization
-  SCIP_CALL_EXC(SCIPcreateConsBasicQuadratic(m_scip_model, &m_targetConstraint.constraint, "cst",
-    0, NULL, NULL, 0, NULL, NULL, NULL, m_sense == MINIMIZE ? NEG_INF : 0, m_sense == MINIMIZE ? 0 : INF));
-  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_targetConstraint.constraint));
+void MILPSolver::createSymresack(VariableSpan vars, const std::vector<fuint32_t> &permutation, const char *name)
+{
+  if (permutation.size() != vars.size()) throw std::invalid_argument("Permutation does not match the variables...");
+  std::vector<int> perm{};
+  std::vector<bool> isImage(vars.size(), false);
+  for (auto image : permutation)
+  {
+    if (image >= vars.size() || isImage[image]) throw std::invalid_argument("Not a permutation...");
+    isImage[image] = true;
+    perm.push_back(image);
+  }
+  auto scipVars = collectVars(vars);
+  for (auto var : scipVars)
+  {
+    if (SCIPvarGetType(var) != SCIP_VARTYPE_BINARY) throw std::invalid_argument("Symresacks need binary variables...");
+  }
 
-  m_targetConstraint.addVariable(m_scip_model, m_targetVar, -1.0);
+  disableAutomaticSymmetry();
+  m_specialCsts.push_back(nullptr);
+  SCIP_CALL_EXC(SCIPcreateConsBasicSymresack(m_scip_model, &m_specialCsts.back(), name, perm.data(), scipVars.data(),
+    scipVars.size(), TRUE));
+  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_specialCsts.back()));
 }
 
-QUBOSolver::~QUBOSolver()
+void MILPSolver::createLexOrder(VariableSpan greater, VariableSpan smaller, const char *name)
 {
-  try
-  {
-    if (m_scip_model == nullptr) return;
+  if (greater.size() != smaller.size()) throw std::invalid_argument("Lexicographically ordered vectors differ in size...");
+  auto greaterVars = collectVars(greater);
+  auto smallerVars = collectVars(smaller);
 
-    for (auto it = m_variables.begin(); it != m_variables.end(); ++it)
-    {
-      SCIP_CALL_EXC(SCIPreleaseVar(m_scip_model, &it->variable));
-    }
-    if (m_targetVar.variable != nullptr)
-    {
-      SCIP_CALL_EXC(SCIPreleaseVar(m_scip_model, &m_targetVar.variable));
-    }
-    if (m_targetConstraint.constraint != nullptr)
+  bool binary = true;
+  double maxDifference = 0.0;
+  for (fuint32_t i = 0; i < greater.size(); i++)
+  {
+    for (auto var : {greaterVars[i], smallerVars[i]})
     {
-      SCIP_CALL_EXC(SCIPreleaseCons(m_scip_model, &m_targetConstraint.constraint));
+      if (SCIPvarGetType(var) == SCIP_VARTYPE_CONTINUOUS) throw std::invalid_argument("Lexicographic order needs integer variables...");
+      binary = binary && SCIPvarGetType(var) == SCIP_VARTYPE_BINARY;
     }
-    SCIP_CALL_EXC(SCIPfree(&m_scip_model));
+    maxDifference = std::max(maxDifference, std::max(SCIPvarGetUbOriginal(greaterVars[i]) - SCIPvarGetLbOriginal(smallerVars[i]),
+                                                     SCIPvarGetUbOriginal(smallerVars[i]) - SCIPvarGetLbOriginal(greaterVars[i])));
+  }
+
+  if (binary)
+  { // (greater, smaller) >=lex (smaller, greater) is a symresack of the permutation swapping both vectors
+    std::vector<fuint32_t> vars(greater.begin(), greater.end());
+    vars.insert(vars.end(), smaller.begin(), smaller.end());
+    std::vector<fuint32_t> permutation{};
+    for (fuint32_t i = 0; i < vars.size(); i++) permutation.push_back((i + greater.size()) % vars.size());
+    createSymresack(VariableSpan{vars}, permutation, name);
+    return;
+  }
+
+  // sum base^(n-1-i) * (greater_i - smaller_i) >= 0 with base exceeding every possible difference
+  const double base = maxDifference + 1.0;
+  if (SCIPisInfinity(m_scip_model, maxDifference) || std::pow(base, greater.size() - 1) * maxDifference > 1e15)
+    throw std::range_error("Bounds too large for a linear lexicographic order...");
+  fuint32_t cst = createLinearConstraintGeq(0.0, name);
+  double weight = 1.0;
+  for (fuint32_t i = greater.size(); i-- > 0;)
+  {
+    addToCst(cst, greater[i], weight);
+    addToCst(cst, smaller[i], -weight);
+    weight *= base;
+  }
+}
+
+void MILPSolver::createSOS1(VariableSpan vars, CoefficientSpan weights, const char *name)
+{
+  if (weights.size() != 0 && weights.size() != vars.size()) throw std::invalid_argument("Amount of variables and weights differs...");
+  auto scipVars = collectVars(vars);
+  m_specialCsts.push_back(nullptr);
+  SCIP_CALL_EXC(SCIPcreateConsBasicSOS1(m_scip_model, &m_specialCsts.back(), name, scipVars.size(), scipVars.data(),
+    weights.size() == 0 ? NULL : const_cast<double*>(weights.begin())));
+  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_specialCsts.back()));
+}
+
+void MILPSolver::createSOS2(VariableSpan vars, CoefficientSpan weights, const char *name)
+{
+  if (weights.size() != 0 && weights.size() != vars.size()) throw std::invalid_argument("Amount of variables and weights differs...");
+  auto scipVars = collectVars(vars);
+  m_specialCsts.push_back(nullptr);
+  SCIP_CALL_EXC(SCIPcreateConsBasicSOS2(m_scip_model, &m_specialCsts.back(), name, scipVars.size(), scipVars.data(),
+    weights.size() == 0 ? NULL : const_cast<double*>(weights.begin())));
+  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_specialCsts.back()));
+}
+
+void MILPSolver::resetTransform()
+{ // plugins can only be included before the problem is transformed
+  freeSolution();
+  if (SCIPgetStage(m_scip_model) != SCIP_STAGE_PROBLEM)
+  {
+    SCIP_CALL_EXC(SCIPfreeTransform(m_scip_model));
+  }
+}
+
+void MILPSolver::addLazyConstraintCallback(LazyConstraintCallback callback, bool separateFractional)
+{
+  resetTransform();
+  m_lazyHandlers.emplace_back(new LazyConstraintHandler(m_variables, callback));
+  includeLazyConstraintHandler(m_scip_model, m_lazyHandlers.back().get(),
+                               "lazy_" + std::to_string(m_lazyHandlers.size() - 1), separateFractional);
+}
+
+fuint32_t MILPSolver::getNbLazyRowsAdded() const
+{
+  fuint32_t nbRows = 0;
+  for (const auto &handler : m_lazyHandlers) nbRows += handler->nbRowsAdded;
+  return nbRows;
+}
+
+void MILPSolver::setLazy(fuint32_t cstIndex)
+{
+  if (cstIndex >= m_csts.size()) throw std::range_error("Out of range in setting constraint lazy...");
+  if (cstIndex < m_nbCommittedRows) throw std::logic_error("Constraint was already committed...");
+
+  if (m_lazyRowPool == nullptr)
+  { // all lazy rows share one pool and one constraint handler
+    m_lazyRowPool.reset(new LazyRowPool());
+    LazyRowPool *pool = m_lazyRowPool.get();
+    double tolerance = SCIPfeastol(m_scip_model);
+    addLazyConstraintCallback([pool, tolerance](SolutionView solution)
+    {
+      return pool->findViolatedRows(solution, tolerance);
+    });
+  }
+  m_lazyRows.insert(cstIndex);
+}
+
+void MILPSolver::addSeparator(SeparatorCallback callback, int priority, int frequency, const std::string &name)
+{
+  resetTransform();
+  std::string sepaName = name.empty() ? "user_" + std::to_string(m_separators.size()) : name;
+  m_separators.emplace_back(new SeparatorHandler(m_variables, callback, sepaName));
+  includeSeparator(m_scip_model, m_separators.back().get(), priority, frequency);
+}
+
+void MILPSolver::printSeparatorStatistics(std::ostream &os) const
+{
+  for (const auto &handler : m_separators)
+  {
+    os << handler->name << ": " << SCIPsepaGetNCalls(handler->separator) << " calls, "
+       << SCIPsepaGetTime(handler->separator) << "s, " << handler->nbCutsAdded << " cuts" << std::endl;
+  }
+}
+
+void MILPSolver::addHeuristic(HeuristicCallback callback, SCIP_HEURTIMING timing, int frequency, const std::string &name)
+{
+  resetTransform();
+  std::string heurName = name.empty() ? "user_heur_" + std::to_string(m_heuristics.size()) : name;
+  m_heuristics.emplace_back(new HeuristicHandler(m_variables, callback, heurName));
+  includeHeuristic(m_scip_model, m_heuristics.back().get(), timing, frequency);
+}
+
+void MILPSolver::printHeuristicStatistics(std::ostream &os) const
+{
+  for (const auto &handler : m_heuristics)
+  {
+    os << handler->name << ": " << SCIPheurGetNCalls(handler->heuristic) << " calls, "
+       << SCIPheurGetTime(handler->heuristic) << "s, " << handler->nbSolutionsStored << " solutions stored" << std::endl;
+  }
+}
+
+void MILPSolver::setBranching(fuint32_t varIndex, int priority, BranchDirection direction)
+{
+  if (varIndex >= m_variables.size()) throw std::range_error("Variable index out of range...");
+  SCIP_CALL_EXC(SCIPchgVarBranchPriority(m_scip_model, m_variables[varIndex].variable, priority));
+  SCIP_CALL_EXC(SCIPchgVarBranchDirection(m_scip_model, m_variables[varIndex].variable, getSCIPBranchDir(direction)));
+}
+
+void MILPSolver::setBranching(VariableSpan vars, int priority, BranchDirection direction)
+{
+  for (auto var : vars) setBranching(var, priority, direction);
+}
+
+void MILPSolver::setDefaultBranching(int priority, BranchDirection direction)
+{
+  m_defaultBranchPriority = priority;
+  m_defaultBranchDirection = direction;
+}
+
+void MILPSolver::addBranchingRule(BranchingCallback callback, const std::string &name)
+{
+  resetTransform();
+  std::string ruleName = name.empty() ? "user_branching_" + std::to_string(m_branchingRules.size()) : name;
+  m_branchingRules.emplace_back(new BranchingHandler(m_variables, callback, ruleName));
+  includeBranchingRule(m_scip_model, m_branchingRules.back().get());
+}
+
+void MILPSolver::addPricer(PricingCallback callback, const std::vector<fuint32_t> &rows, const std::string &name)
+{
+  for (auto row : rows)
+  {
+    if (row >= m_csts.size()) throw std::range_error("Constraint index out of range...");
+    if (row < m_nbCommittedRows) throw std::logic_error("Priced rows must not be committed yet...");
+    if (m_lazyRows.count(row) != 0) throw std::invalid_argument("Priced rows cannot be lazy...");
+    m_pricedRows.insert(row);
+  }
+
+  resetTransform();
+  std::string pricerName = name.empty() ? "user_pricer_" + std::to_string(m_pricers.size()) : name;
+  m_pricers.emplace_back(new PricerHandler(m_csts, rows, callback, pricerName));
+  includePricer(m_scip_model, m_pricers.back().get());
+
+  // restarts and cuts would not know about the columns priced later on
+  SCIP_CALL_EXC(SCIPsetIntParam(m_scip_model, "presolving/maxrestarts", 0));
+  SCIP_CALL_EXC(SCIPsetSeparating(m_scip_model, SCIP_PARAMSETTING_OFF, TRUE));
+  disableAutomaticSymmetry();
+}
+
+std::vector<std::pair<fuint32_t, double>> MILPSolver::getPricedColumnValues()
+{
+  std::vector<std::pair<fuint32_t, double>> values{};
+  if (m_solution == nullptr) return values;
+  for (const auto &pricer : m_pricers)
+  {
+    for (const auto &column : pricer->columns)
+    {
+      double value = SCIPgetSolVal(m_scip_model, m_solution, column.second);
+      if (std::abs(value) > SCIPfeastol(m_scip_model)) values.push_back(std::make_pair(column.first, value));
+    }
+  }
+  return values;
+}
+
+fuint32_t MILPSolver::getNbPricedColumns() const
+{
+  fuint32_t nbColumns = 0;
+  for (const auto &pricer : m_pricers) nbColumns += pricer->columns.size();
+  return nbColumns;
+}
+
+void MILPSolver::addBendersSubproblem(MILPSolver &subproblem, const std::vector<std::pair<fuint32_t, fuint32_t>> &linkingVars)
+{
+  if (m_bendersCreated) throw std::logic_error("Benders subproblems must be added before solving the master...");
+  if (&subproblem == this) throw std::invalid_argument("The master cannot be its own subproblem...");
+  if (SCIPgetObjsense(m_scip_model) != SCIP_OBJSENSE_MINIMIZE || SCIPgetObjsense(subproblem.m_scip_model) != SCIP_OBJSENSE_MINIMIZE)
+  {
+    throw std::invalid_argument("Benders decomposition needs minimization problems...");
+  }
+
+  for (const auto &link : linkingVars)
+  { // the default Benders decomposition maps master and subproblem variables by their names
+    if (link.first >= m_variables.size() || link.second >= subproblem.m_variables.size())
+    {
+      throw std::range_error("Variable index out of range...");
+    }
+    std::string name = "benders_link_" + std::to_string(link.first);
+    SCIP_CALL_EXC(SCIPchgVarName(m_scip_model, m_variables[link.first].variable, name.c_str()));
+    SCIP_CALL_EXC(SCIPchgVarName(subproblem.m_scip_model, subproblem.m_variables[link.second].variable, name.c_str()));
+    m_bendersLinkVars.insert(link.first);
+    subproblem.m_bendersLinkVars.insert(link.second);
+  }
+  m_bendersSubproblems.push_back(&subproblem);
+}
+
+bool MILPSolver::setBendersThreads(int threads)
+{ // only available if SCIP was built with a parallel task interface
+  if (SCIPgetParam(m_scip_model, "benders/default/numthreads") == nullptr) return false;
+  SCIP_CALL_EXC(SCIPsetIntParam(m_scip_model, "benders/default/numthreads", threads));
+  return true;
+}
+
+void MILPSolver::nameBendersVars(const std::string &prefix)
+{ // unique names for the variables that are not linked, otherwise they would be matched by their (empty) names
+  for (fuint32_t i = 0; i < m_variables.size(); i++)
+  {
+    if (m_bendersLinkVars.count(i) != 0) continue;
+    std::string name = prefix + "_" + std::to_string(i);
+    SCIP_CALL_EXC(SCIPchgVarName(m_scip_model, m_variables[i].variable, name.c_str()));
+  }
+}
+
+void MILPSolver::createBenders()
+{
+  resetTransform();
+  nameBendersVars(m_name + "_master");
+  std::vector<SCIP*> subproblems{};
+  for (auto *subproblem : m_bendersSubproblems)
+  {
+    subproblem->commitRows();
+    subproblem->nameBendersVars(subproblem->m_name + "_sub" + std::to_string(subproblems.size()));
+    subproblems.push_back(subproblem->m_scip_model);
+  }
+  SCIP_CALL_EXC(SCIPcreateBendersDefault(m_scip_model, subproblems.data(), subproblems.size()));
+  m_bendersCreated = true;
+}
+
+void MILPSolver::printBendersStatistics(std::ostream &os) const
+{
+  SCIP_BENDERS *benders = SCIPfindBenders(m_scip_model, "default");
+  if (benders == nullptr || !m_bendersCreated) return;
+  os << "benders: " << m_bendersSubproblems.size() << " subproblems, " << SCIPbendersGetNCalls(benders) << " calls, "
+     << SCIPbendersGetNCutsFound(benders) << " cuts found" << std::endl;
+}
+
+void MILPSolver::createCardinalityConstraint(VariableSpan vars, fuint32_t k, VariableSpan indicatorVars,
+                                             CoefficientSpan weights, const char *name)
+{ // without indicator variables, cons_cardinality creates them itself
+  if (weights.size() != 0 && weights.size() != vars.size()) throw std::invalid_argument("Amount of variables and weights differs...");
+  if (indicatorVars.size() != 0 && indicatorVars.size() != vars.size())
+    throw std::invalid_argument("Amount of variables and indicator variables differs...");
+  auto scipVars = collectVars(vars);
+  auto scipIndicatorVars = collectVars(indicatorVars);
+  m_specialCsts.push_back(nullptr);
+  SCIP_CALL_EXC(SCIPcreateConsBasicCardinality(m_scip_model, &m_specialCsts.back(), name, scipVars.size(), scipVars.data(), k,
+    scipIndicatorVars.empty() ? NULL : scipIndicatorVars.data(), weights.size() == 0 ? NULL : const_cast<double*>(weights.begin())));
+  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_specialCsts.back()));
+}
+
+std::vector<SCIP_VAR*> MILPSolver::collectVars(VariableSpan vars)
+{
+  std::vector<SCIP_VAR*> scipVars{};
+  scipVars.reserve(vars.size());
+  for (auto var : vars)
+  {
+    if (var >= m_variables.size()) throw std::range_error("Variable index out of range...");
+    scipVars.push_back(m_variables[var].variable);
+  }
+  return scipVars;
+}
+
+void MILPSolver::collectRow(const LinearRow &row, std::vector<SCIP_VAR*> &vars, std::vector<double> &coefficients, double sign)
+{
+  if (row.vars.size() != row.coefficients.size()) throw std::invalid_argument("Amount of variables and coefficients differs...");
+  vars.clear();
+  coefficients.clear();
+  for (fuint32_t i = 0; i < row.vars.size(); i++)
+  {
+    if (row.vars[i] >= m_variables.size()) throw std::range_error("Out of range in adding to constraint...");
+    vars.push_back(m_variables[row.vars[i]].variable);
+    coefficients.push_back(sign * row.coefficients[i]);
+  }
+}
+
+void MILPSolver::addToCst(fuint32_t cstIndex, fuint32_t varIndex, double coefficient)
+{
+  if (m_csts.size() <= cstIndex || varIndex >= m_variables.size())
+    throw std::range_error("Out of range in adding to constraint...");
+
+  if (cstIndex < m_nbCommittedRows)
+  { // only rows that stayed linear can be changed after commit
+    if (m_lazyRows.count(cstIndex) != 0) throw std::logic_error("Lazy row cannot be changed after commit...");
+    SCIP_CONS *cons = m_csts.at(cstIndex).constraint;
+    if (std::strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "linear") != 0)
+      throw std::logic_error("Constraint was upgraded and cannot be changed anymore...");
+    m_csts.at(cstIndex).addVariable(m_scip_model, m_variables.at(varIndex), coefficient);
+  }
+  m_rows.at(cstIndex).addVariable(varIndex, coefficient);
+  m_modelHash.addNonzero(cstIndex, varIndex, coefficient);
+}
+
+void MILPSolver::merge(ModelBuilder &builder)
+{
+  if (&builder.m_solver != this) throw std::invalid_argument("Builder belongs to another solver...");
+  if (m_variables.size() != builder.m_firstVar || m_csts.size() != builder.m_firstRow)
+  {
+    throw std::logic_error("Model was changed while the builder was in use...");
+  }
+  // the ranges of all contexts ordered by their first index have to cover the reserved indices without gaps
+  typedef std::pair<const BuildContext::Range*, BuildContext*> Part;
+  auto collectParts = [&builder](bool vars, fuint32_t first, fuint32_t end)
+  {
+    std::vector<Part> parts{};
+    for (auto &context : builder.m_contexts)
+    {
+      for (const auto &range : vars ? context->m_varRanges : context->m_rowRanges) parts.push_back(Part{&range, context.get()});
+    }
+    std::sort(parts.begin(), parts.end(), [](const Part &a, const Part &b) { return a.first->first < b.first->first; });
+    for (const auto &part : parts)
+    {
+      if (part.first->first != first || part.first->used != part.first->reserved)
+      {
+        throw std::logic_error(std::string{"Reserved "} + (vars ? "variables" : "rows") + " were not created...");
+      }
+      first += part.first->reserved;
+    }
+    if (first != end) throw std::logic_error(std::string{"Reserved "} + (vars ? "variables" : "rows") + " were not created...");
+    return parts;
+  };
+  std::vector<Part> varParts = collectParts(true, builder.m_firstVar, builder.m_nextVar.load());
+  std::vector<Part> rowParts = collectParts(false, builder.m_firstRow, builder.m_nextRow.load());
+
+  setNbVars(builder.m_nextVar.load());
+  for (const auto &part : varParts)
+  {
+    const BuildContext &context = *part.second;
+    for (fuint32_t i = part.first->offset; i < part.first->offset + part.first->used; i++)
+    {
+      createVar(context.m_types[i], context.m_lowerBounds[i], context.m_upperBounds[i], context.m_objective[i]);
+    }
+  }
+  setNbCsts(builder.m_nextRow.load());
+  for (const auto &part : rowParts)
+  { // rows are moved, thus their coefficients are not copied
+    BuildContext &context = *part.second;
+    for (fuint32_t i = part.first->offset; i < part.first->offset + part.first->used; i++)
+    {
+      m_csts.push_back(SCIPLinearConstraint{nullptr});
+      m_modelHash.addRow(context.m_rows[i].lhs, context.m_rows[i].rhs);
+      m_rows.push_back(std::move(context.m_rows[i]));
+    }
+  }
+  for (const auto &context : builder.m_contexts) m_modelHash.addNonzeros(context->m_hash);
+
+  builder.m_contexts.clear();
+  builder.m_firstVar = m_variables.size();
+  builder.m_firstRow = m_csts.size();
+}
+
+SCIPLinearConstraint *MILPSolver::getCst(fuint32_t index)
+{
+  if (index >= m_csts.size()) return nullptr;
+  commitRows();
+  return &m_csts.at(index);
+}
+
+void MILPSolver::commitRows()
+{
+  for (; m_nbCommittedRows < m_rows.size(); m_nbCommittedRows++)
+  {
+    m_rowStatistics[commitRow(m_nbCommittedRows)]++;
+  }
+}
+
+RowKind MILPSolver::commitRow(fuint32_t index)
+{
+  const auto& row = m_rows[index];
+  if (m_lazyRows.count(index) != 0)
+  {
+    m_lazyRowPool->addRow(row);
+    return LAZY_ROW;
+  }
+  const auto nameIt = m_rowNames.find(index);
+  const char *name = nameIt == m_rowNames.end() ? "" : nameIt->second.c_str();
+  SCIP_CONS **cons = &m_csts[index].constraint;
+
+  RowKind kind = LINEAR_ROW;
+  const bool modifiable = m_pricedRows.count(index) != 0; // priced columns are added to the row later on
+  if (modifiable || !m_upgradeRows || !upgradeRow(row, name, cons, kind))
+  {
+    std::vector<SCIP_VAR*> vars{};
+    std::vector<double> coefficients{};
+    collectRow(row, vars, coefficients, 1.0);
+    SCIP_CALL_EXC(SCIPcreateConsLinear(m_scip_model, cons, name, vars.size(), vars.data(), coefficients.data(),
+      row.lhs, row.rhs, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, modifiable, FALSE, FALSE, FALSE));
+    kind = LINEAR_ROW;
+  }
+  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, *cons));
+  return kind;
+}
+
+bool MILPSolver::upgradeRow(const LinearRow &row, const char *name, SCIP_CONS **cons, RowKind &kind)
+{
+  // merge duplicate variables and drop zeros
+  std::vector<std::pair<fuint32_t, double>> terms{};
+  terms.reserve(row.vars.size());
+  for (fuint32_t i = 0; i < row.vars.size(); i++)
+  {
+    if (row.vars[i] >= m_variables.size()) throw std::range_error("Out of range in adding to constraint...");
+    terms.push_back(std::make_pair(row.vars[i], row.coefficients.at(i)));
+  }
+  std::sort(terms.begin(), terms.end());
+  fuint32_t nbTerms = 0;
+  for (fuint32_t i = 0; i < terms.size(); i++)
+  {
+    if (nbTerms > 0 && terms[nbTerms - 1].first == terms[i].first) terms[nbTerms - 1].second += terms[i].second;
+    else terms[nbTerms++] = terms[i];
+  }
+  terms.resize(nbTerms);
+  terms.erase(std::remove_if(terms.begin(), terms.end(),
+    [](const std::pair<fuint32_t, double> &term) { return term.second == 0.0; }), terms.end());
+  if (terms.empty()) return false;
+
+  const bool lhsInfinite = SCIPisInfinity(m_scip_model, -row.lhs);
+  const bool rhsInfinite = SCIPisInfinity(m_scip_model, row.rhs);
+  bool allBinary = true;
+  bool allUnit = true;
+  bool allIntegral = true;
+  for (const auto& term : terms)
+  {
+    allBinary = allBinary && SCIPvarGetType(m_variables[term.first].variable) == SCIP_VARTYPE_BINARY;
+    allUnit = allUnit && std::abs(term.second) == 1.0;
+    allIntegral = allIntegral && isIntegral(term.second);
+  }
+
+  std::vector<SCIP_VAR*> vars{};
+  vars.reserve(terms.size());
+  if (allBinary && allUnit)
+  { // -x = x' - 1 with x' the negated variable, then it is a sum of binaries
+    double shift = 0.0;
+    for (const auto& term : terms)
+    {
+      SCIP_VAR *var = m_variables[term.first].variable;
+      if (term.second < 0.0)
+      {
+        SCIP_CALL_EXC(SCIPgetNegatedVar(m_scip_model, var, &var));
+        shift += 1.0;
+      }
+      vars.push_back(var);
+    }
+    const double lhs = row.lhs + shift;
+    const double rhs = row.rhs + shift;
+    if (!lhsInfinite && !rhsInfinite && SCIPisEQ(m_scip_model, lhs, 1.0) && SCIPisEQ(m_scip_model, rhs, 1.0))
+    {
+      SCIP_CALL_EXC(SCIPcreateConsBasicSetpart(m_scip_model, cons, name, vars.size(), vars.data()));
+      kind = SETPPC_ROW;
+      return true;
+    }
+    if (!rhsInfinite && SCIPisEQ(m_scip_model, rhs, 1.0) && (lhsInfinite || SCIPisLE(m_scip_model, lhs, 0.0)))
+    {
+      SCIP_CALL_EXC(SCIPcreateConsBasicSetpack(m_scip_model, cons, name, vars.size(), vars.data()));
+      kind = SETPPC_ROW;
+      return true;
+    }
+    if (!lhsInfinite && SCIPisEQ(m_scip_model, lhs, 1.0) && (rhsInfinite || SCIPisGE(m_scip_model, rhs, vars.size())))
+    {
+      SCIP_CALL_EXC(SCIPcreateConsBasicLogicor(m_scip_model, cons, name, vars.size(), vars.data()));
+      kind = LOGICOR_ROW;
+      return true;
+    }
+  }
+
+  if (terms.size() == 2)
+  { // lhs <= x + c * y <= rhs with y not continuous
+    fuint32_t yPos = SCIPvarGetType(m_variables[terms[1].first].variable) != SCIP_VARTYPE_CONTINUOUS ? 1 : 0;
+    const auto& x = terms[1 - yPos];
+    const auto& y = terms[yPos];
+    if (SCIPvarGetType(m_variables[y.first].variable) != SCIP_VARTYPE_CONTINUOUS)
+    {
+      // dividing by a negative coefficient swaps the sides, an infinite side keeps pointing outwards
+      const bool negative = x.second < 0.0;
+      double lhs = (negative ? rhsInfinite : lhsInfinite) ? NEG_INF : (negative ? row.rhs : row.lhs) / x.second;
+      double rhs = (negative ? lhsInfinite : rhsInfinite) ? INF : (negative ? row.lhs : row.rhs) / x.second;
+      SCIP_CALL_EXC(SCIPcreateConsBasicVarbound(m_scip_model, cons, name, m_variables[x.first].variable,
+        m_variables[y.first].variable, y.second / x.second, lhs, rhs));
+      kind = VARBOUND_ROW;
+      return true;
+    }
+  }
+
+  if (allBinary && allIntegral && lhsInfinite != rhsInfinite)
+  { // sum w_i x_i <= c with w_i > 0, negative weights are turned around by negated variables
+    const double sign = rhsInfinite ? -1.0 : 1.0;
+    double capacity = sign * (rhsInfinite ? row.lhs : row.rhs);
+    std::vector<SCIP_Longint> weights{};
+    weights.reserve(terms.size());
+    vars.clear();
+    for (const auto& term : terms)
+    {
+      SCIP_VAR *var = m_variables[term.first].variable;
+      double weight = sign * term.second;
+      if (weight < 0.0)
+      {
+        SCIP_CALL_EXC(SCIPgetNegatedVar(m_scip_model, var, &var));
+        capacity -= weight;
+        weight = -weight;
+      }
+      vars.push_back(var);
+      weights.push_back(std::llround(weight));
+    }
+    if (capacity < 0.0) return false; // infeasible, leave it to cons_linear
+    SCIP_CALL_EXC(SCIPcreateConsBasicKnapsack(m_scip_model, cons, name, vars.size(), vars.data(), weights.data(),
+      static_cast<SCIP_Longint>(std::floor(capacity + 1e-9))));
+    kind = KNAPSACK_ROW;
+    return true;
+  }
+  return false;
+}
+
+void MILPSolver::printRowStatistics(std::ostream &os) const
+{
+  os << m_nbCommittedRows << " rows committed, " << getNbUpgradedRows() << " upgraded:" << std::endl;
+  for (fuint32_t kind = 0; kind < NB_ROW_KINDS; kind++)
+  {
+    os << "  " << getRowKindName(static_cast<RowKind>(kind)) << ": " << m_rowStatistics[kind] << std::endl;
+  }
+}
+
+
+/* ------------------------ QUBOSolver ------------------------ */
+
+QUBOSolver::QUBOSolver(SolverSense sense, double penalty)
+  : m_penalty(penalty), m_sense(sense), m_solution(nullptr), m_autoPenalty(penalty == AUTO_PENALTY),
+    m_currentGroup(0), m_maxRefinements(0), m_refinementFactor(2.0)
+{
+  SCIP_CALL_EXC(SCIPcreate(&m_scip_model));
+  SCIP_CALL_EXC(SCIPincludeDefaultPlugins(m_scip_model));
+  createProblem();
+}
+
+void QUBOSolver::createProblem()
+{
+  SCIP_CALL_EXC(SCIPcreateProb(m_scip_model, "", NULL, NULL,NULL, NULL, NULL, NULL, NULL));
+  SCIP_CALL_EXC(SCIPsetObjsense(m_scip_model, getSCIPObjSense(m_sense)));
+
+  // create optimization variable
+  SCIP_CALL_EXC(SCIPcreateVar(m_scip_model, &m_targetVar.variable, "target",
+      NEG_INF, INF, 1.0, getSCIPVarType(CONTINUOUS), TRUE, FALSE,NULL, NULL, NULL, NULL, NULL));
+  SCIP_CALL_EXC(SCIPaddVar(m_scip_model, m_targetVar.variable));
+
+  createTargetConstraint();
+  m_groups.push_back(PenaltyGroup{m_penalty});
+}
+
+void QUBOSolver::releaseModel()
+{
+  for (auto it = m_variables.begin(); it != m_variables.end(); ++it)
+  {
+    SCIP_CALL_EXC(SCIPreleaseVar(m_scip_model, &it->variable));
+  }
+  m_variables.clear();
+  if (m_targetVar.variable != nullptr)
+  {
+    SCIP_CALL_EXC(SCIPreleaseVar(m_scip_model, &m_targetVar.variable));
+  }
+  if (m_targetConstraint.constraint != nullptr)
+  {
+    SCIP_CALL_EXC(SCIPreleaseCons(m_scip_model, &m_targetConstraint.constraint));
+  }
+}
+
+void QUBOSolver::clearModel(SolverSense sense, double penalty)
+{
+  resetTransform();
+  releaseModel();
+  SCIP_CALL_EXC(SCIPfreeProb(m_scip_model));
+  m_coefficients.clear();
+  m_pushedCoefficients.clear();
+  m_groups.clear();
+  m_values.clear();
+  m_sense = sense;
+  m_penalty = penalty;
+  m_autoPenalty = penalty == AUTO_PENALTY;
+  m_currentGroup = 0;
+  createProblem();
+}
+
+QUBOSolver::~QUBOSolver()
+{
+  try
+  {
+    if (m_scip_model == nullptr) return;
+
+    releaseModel();
+    SCIP_CALL_EXC(SCIPfree(&m_scip_model));
   }
   catch(const std::exception& e)
   {
@@ -262,29 +1596,139 @@ QUBOSolver::~QUBOSolver()
 
 bool QUBOSolver::solve()
 {
-  if(m_solution != nullptr) return true;
-  fillTargetConstraint();
+  if (m_autoPenalty) calibratePenalties();
+  QUBOTermVec coefficients = getEffectiveCoefficients();
+  if (m_solution != nullptr && coefficients == m_pushedCoefficients) return true; // nothing changed since last solve
+
+  resetTransform();
+  fillTargetConstraint(coefficients);
+  addWarmStart();
+  solveModel();
+
+  for (fuint32_t round = 0; round < m_maxRefinements && m_solution != nullptr; round++)
+  { // the calibrated penalties were not sufficient, scale up the violated groups and try again
+    if (!refinePenalties()) break;
+    resetTransform();
+    fillTargetConstraint(getEffectiveCoefficients());
+    addWarmStart();
+    solveModel();
+  }
+  return m_solution != nullptr;
+}
+
+void QUBOSolver::solveModel()
+{
   SCIP_CALL_EXC(SCIPsolve(m_scip_model));
   m_solution = SCIPgetBestSol(m_scip_model);
-  return m_solution != nullptr;
+  m_values.clear();
+  if (m_solution == nullptr) return;
+  m_values.resize(m_variables.size());
+  for (fuint32_t i = 0; i < m_variables.size(); i++)
+  {
+    m_values[i] = SCIPgetSolVal(m_scip_model, m_solution, m_variables[i].variable) > 0.5;
+  }
+}
+
+void QUBOSolver::resetTransform()
+{ // the original problem can only be changed in the problem stage (values of the last solve are kept)
+  m_solution = nullptr;
+  if (SCIPgetStage(m_scip_model) != SCIP_STAGE_PROBLEM)
+  {
+    SCIP_CALL_EXC(SCIPfreeTransform(m_scip_model));
+  }
+}
+
+void QUBOSolver::addWarmStart()
+{ // the best assignment of the last solve (new variables set to 0) serves as start solution
+  if (m_values.empty()) return;
+  std::vector<SCIP_VAR*> vars{};
+  std::vector<double> vals{};
+  vars.reserve(m_variables.size() + 1);
+  vals.reserve(m_variables.size() + 1);
+  for (fuint32_t i = 0; i < m_variables.size(); i++)
+  {
+    vars.push_back(m_variables[i].variable);
+    vals.push_back(getValue(i) ? 1.0 : 0.0);
+  }
+
+  double target = 0.0;
+  for (const auto& term : m_pushedCoefficients)
+  {
+    if (getValue(term.x) && getValue(term.y)) target += term.coefficient;
+  }
+  vars.push_back(m_targetVar.variable);
+  vals.push_back(target);
+
+  SCIP_SOL *startSolution;
+  SCIP_Bool stored;
+  SCIP_CALL_EXC(SCIPcreateOrigSol(m_scip_model, &startSolution, NULL));
+  SCIP_CALL_EXC(SCIPsetSolVals(m_scip_model, startSolution, vars.size(), vars.data(), vals.data()));
+  SCIP_CALL_EXC(SCIPaddSolFree(m_scip_model, &startSolution, &stored));
 }
 
+void QUBOSolver::createTargetConstraint()
+{
+  // create constraint for optimization
+  SCIP_CALL_EXC(SCIPcreateConsBasicQuadratic(m_scip_model, &m_targetConstraint.constraint, "cst",
+    0, NULL, NULL, 0, NULL, NULL, NULL, m_sense == MINIMIZE ? NEG_INF : 0, m_sense == MINIMIZE ? 0 : INF));
+  SCIP_CALL_EXC(SCIPaddCons(m_scip_model, m_targetConstraint.constraint));
+
+  m_targetConstraint.addVariable(m_scip_model, m_targetVar, -1.0);
+}
 
-void QUBOSolver::fillTargetConstraint()
+void QUBOSolver::fillTargetConstraint(const QUBOTermVec &coefficients)
 {
-  for (auto coefficientIt = m_coefficients.begin(); coefficientIt != m_coefficients.end(); ++coefficientIt)
+  // only the difference to the terms already in the constraint is pushed (SCIP sums up duplicate terms)
+  auto pushed = m_pushedCoefficients.begin();
+  auto pushTerm = [this](fuint32_t x, fuint32_t y, double coefficient)
   {
-    auto& varPair = coefficientIt->first;
-    auto coefficient = coefficientIt->second;
-    if (varPair.first == varPair.second)
-      m_targetConstraint.addVariable(m_scip_model, m_variables.at(varPair.first), coefficient);
+    if (coefficient == 0.0) return;
+    if (x == y)
+      m_targetConstraint.addVariable(m_scip_model, m_variables.at(x), coefficient);
     else
-      m_targetConstraint.addQuadratic(m_scip_model, m_variables.at(varPair.first), m_variables.at(varPair.second), coefficient);
+      m_targetConstraint.addQuadratic(m_scip_model, m_variables.at(x), m_variables.at(y), coefficient);
+  };
+
+  for (const auto& term : coefficients)
+  {
+    for (; pushed != m_pushedCoefficients.end() && *pushed < term; ++pushed)
+    { // term vanished
+      pushTerm(pushed->x, pushed->y, -pushed->coefficient);
+    }
+    if (pushed != m_pushedCoefficients.end() && pushed->x == term.x && pushed->y == term.y)
+    {
+      pushTerm(term.x, term.y, term.coefficient - pushed->coefficient);
+      ++pushed;
+    }
+    else
+    {
+      pushTerm(term.x, term.y, term.coefficient);
+    }
+  }
+  for (; pushed != m_pushedCoefficients.end(); ++pushed)
+  {
+    pushTerm(pushed->x, pushed->y, -pushed->coefficient);
+  }
+  m_pushedCoefficients = coefficients;
+}
+
+QUBOTermVec QUBOSolver::getEffectiveCoefficients() const
+{
+  QUBOTermVec coefficients = m_coefficients;
+  for (const auto& group : m_groups)
+  {
+    for (const auto& term : group.terms)
+    {
+      coefficients.push_back(QUBOTerm{term.x, term.y, term.coefficient * group.penalty});
+    }
   }
+  mergeTerms(coefficients);
+  return coefficients;
 }
 
 fuint32_t QUBOSolver::createBinaryVar()
 {
+  resetTransform();
   m_variables.push_back(SCIPVariable{});
   SCIP_CALL_EXC(SCIPcreateVar(m_scip_model, &m_variables.back().variable, "",
       0.0, 1.0, 0.0, getSCIPVarType(BINARY), TRUE, FALSE,NULL, NULL, NULL, NULL, NULL));
@@ -294,24 +1738,17 @@ fuint32_t QUBOSolver::createBinaryVar()
 }
 
 bool QUBOSolver::getBinaryValue(fuint32_t x)
-{
-  if (m_solution == nullptr) throw std::runtime_error("Solution is nullptr...");
+{ // values of the last solve stay available while the QUBO is changed
+  if (m_values.empty()) throw std::runtime_error("Solution is nullptr...");
   if (x >= m_variables.size()) throw std::range_error("Variable index out of range...");
-  return SCIPgetSolVal(m_scip_model, m_solution, m_variables.at(x).variable) > 0.5;
+  return getValue(x);
 }
 
 void QUBOSolver::addQuadraticTerm(fuint32_t x, fuint32_t y, double coefficient, bool withPenalty)
 {
-  auto it = m_coefficients.find(VariablePair(std::min(x, y), std::max(x, y)));
-  if (it == m_coefficients.end())
-  {
-    m_coefficients.insert(std::make_pair(VariablePair(std::min(x, y), std::max(x, y)),
-      coefficient * (withPenalty ? m_penalty : 1.0)));
-  }
-  else
-  {
-    it->second += coefficient * (withPenalty ? m_penalty : 1.0);
-  }
+  // terms are only appended, duplicates are merged when the matrix is needed
+  auto& terms = withPenalty ? m_groups.at(m_currentGroup).terms : m_coefficients;
+  terms.push_back(QUBOTerm{std::min(x, y), std::max(x, y), coefficient});
 }
 
 void QUBOSolver::addLinearTerm(fuint32_t x, double coefficient, bool withPenalty)
@@ -319,9 +1756,15 @@ void QUBOSolver::addLinearTerm(fuint32_t x, double coefficient, bool withPenalty
   addQuadraticTerm(x, x, coefficient, withPenalty);
 }
 
-void QUBOSolver::addImplicationTerm(fuint32_t x, fuint32_t y)
-{
+void QUBOSolver::addConstantTerm(double constant, bool withPenalty)
+{ // constants do not change the optimum, but a penalty group needs them to tell whether it is violated
+  if (withPenalty) m_groups.at(m_currentGroup).constant += constant;
+}
 
+void QUBOSolver::addImplicationTerm(fuint32_t x, fuint32_t y)
+{ // x => y: P(x - x*y)
+  addLinearTerm(x, 1.0, true);
+  addQuadraticTerm(x, y, -1.0, true);
 }
 
 void QUBOSolver::addEqualityTerm(fuint32_t x, fuint32_t y)
@@ -332,8 +1775,10 @@ void QUBOSolver::addEqualityTerm(fuint32_t x, fuint32_t y)
 }
 
 void QUBOSolver::addAndTerm(fuint32_t x, fuint32_t y)
-{
-
+{ // x + y = 2: P(2 - x - y)
+  addConstantTerm(2.0);
+  addLinearTerm(x, -1.0, true);
+  addLinearTerm(y, -1.0, true);
 }
 
 void QUBOSolver::addNandTerm(fuint32_t x, fuint32_t y)
@@ -343,36 +1788,207 @@ void QUBOSolver::addNandTerm(fuint32_t x, fuint32_t y)
 
 void QUBOSolver::addXorTerm(fuint32_t x, fuint32_t y)
 { // x + y = 1
+  addConstantTerm(1.0);
   addLinearTerm(x, -1.0, true);
   addLinearTerm(y, -1.0, true);
   addQuadraticTerm(x, y, 2.0, true);
 }
 
 void QUBOSolver::addLeqTerm(fuint32_t x, fuint32_t y)
-{
-
+{ // x + y <= 1 (counterpart to addGeqTerm)
+  addNandTerm(x, y);
 }
 
 void QUBOSolver::addGeqTerm(fuint32_t x, fuint32_t y)
 { // P(1 - x - y + x*y)
+  addConstantTerm(1.0);
   addLinearTerm(x, -1.0, true);
   addLinearTerm(y, -1.0, true);
   addQuadraticTerm(x, y, 1.0, true);
 }
 
+void QUBOSolver::addOneHot(VariableSpan vars)
+{ // sum x_i = 1
+  addSquaredPenalty(vars, nullptr, 1.0);
+}
+
+void QUBOSolver::addCardinality(VariableSpan vars, fuint32_t k)
+{ // sum x_i = k
+  addSquaredPenalty(vars, nullptr, k);
+}
+
+void QUBOSolver::addAtMostK(VariableSpan vars, fuint32_t k)
+{ // sum x_i <= k
+  if (k >= vars.size()) return;
+  if (k == 0)
+  {
+    for (auto x : vars) addLinearTerm(x, 1.0, true);
+    return;
+  }
+  if (k == 1)
+  { // pairwise conflicts, no slack variables needed
+    auto& terms = m_groups.at(m_currentGroup).terms;
+    terms.reserve(terms.size() + vars.size() * (vars.size() - 1) / 2);
+    for (std::size_t i = 0; i < vars.size(); i++)
+    {
+      for (std::size_t j = i + 1; j < vars.size(); j++)
+      {
+        terms.push_back(QUBOTerm{std::min(vars[i], vars[j]), std::max(vars[i], vars[j]), 1.0});
+      }
+    }
+    return;
+  }
+
+  // sum x_i + s = k with 0 <= s <= k encoded by binary slack variables 1, 2, 4, ..., remainder
+  std::vector<fuint32_t> allVars{vars.begin(), vars.end()};
+  std::vector<double> coefficients(vars.size(), 1.0);
+  fuint32_t remaining = k;
+  for (fuint32_t weight = 1; remaining > 0; weight *= 2)
+  {
+    fuint32_t slackWeight = std::min(weight, remaining);
+    allVars.push_back(createBinaryVar());
+    coefficients.push_back(slackWeight);
+    remaining -= slackWeight;
+  }
+  addSquaredPenalty(allVars, coefficients.data(), k);
+}
+
+void QUBOSolver::addLinearEquality(VariableSpan vars, CoefficientSpan coefficients, double rhs)
+{ // sum a_i x_i = b
+  if (vars.size() != coefficients.size()) throw std::invalid_argument("Amount of variables and coefficients differs...");
+  addSquaredPenalty(vars, coefficients.begin(), rhs);
+}
+
+void QUBOSolver::addSquaredPenalty(VariableSpan vars, const double *coefficients, double rhs)
+{
+  // P(sum a_i x_i - b)^2 = P(sum a_i (a_i - 2b) x_i + 2 sum_{i<j} a_i a_j x_i x_j + b^2) as x_i^2 = x_i
+  // (coefficients == nullptr means a_i = 1)
+  auto& group = m_groups.at(m_currentGroup);
+  auto& terms = group.terms;
+  const std::size_t n = vars.size();
+  terms.reserve(terms.size() + n + n * (n - 1) / 2);
+  for (std::size_t i = 0; i < n; i++)
+  {
+    const double a_i = coefficients == nullptr ? 1.0 : coefficients[i];
+    terms.push_back(QUBOTerm{vars[i], vars[i], a_i * (a_i - 2.0 * rhs)});
+    for (std::size_t j = i + 1; j < n; j++)
+    {
+      const double a_j = coefficients == nullptr ? 1.0 : coefficients[j];
+      terms.push_back(QUBOTerm{std::min(vars[i], vars[j]), std::max(vars[i], vars[j]), 2.0 * a_i * a_j});
+    }
+  }
+  group.constant += rhs * rhs;
+}
+
+
+fuint32_t QUBOSolver::addPenaltyGroup()
+{
+  m_groups.push_back(PenaltyGroup{m_penalty});
+  m_currentGroup = m_groups.size() - 1;
+  return m_currentGroup;
+}
+
+void QUBOSolver::setPenaltyGroup(fuint32_t group)
+{
+  if (group >= m_groups.size()) throw std::range_error("Penalty group index out of range...");
+  m_currentGroup = group;
+}
+
+double QUBOSolver::getPenalty(fuint32_t group) const
+{
+  if (group >= m_groups.size()) throw std::range_error("Penalty group index out of range...");
+  return m_groups[group].penalty;
+}
+
+void QUBOSolver::setPenalty(fuint32_t group, double penalty)
+{ // an explicitly set penalty must not be overwritten by the calibration
+  if (group >= m_groups.size()) throw std::range_error("Penalty group index out of range...");
+  m_groups[group].penalty = penalty;
+  m_groups[group].explicitPenalty = true;
+}
+
+void QUBOSolver::calibratePenalties()
+{
+  // Every helper term evaluates to at least 1 if it is violated (given integral coefficients).
+  // Changing only the variables of a group changes the objective by at most the sum of the absolute
+  // values of the objective terms touching these variables. Hence, a penalty exceeding that bound
+  // makes repairing a violation of the group always worthwhile.
+  std::vector<bool> inGroup{};
+  mergeTerms(m_coefficients);
+  for (auto& group : m_groups)
+  {
+    if (group.explicitPenalty) continue;
+    inGroup.assign(m_variables.size(), false);
+    for (const auto& term : group.terms)
+    {
+      inGroup[term.x] = true;
+      inGroup[term.y] = true;
+    }
+
+    double bound = 0.0;
+    for (const auto& term : m_coefficients)
+    {
+      if (inGroup[term.x] || inGroup[term.y]) bound += std::abs(term.coefficient);
+    }
+    // never lower a penalty, it might have been raised by an adaptive refinement before
+    group.penalty = static_cast<double>(m_sense) * std::max(std::abs(group.penalty), bound + 1.0);
+  }
+}
+
+void QUBOSolver::setAdaptivePenalty(fuint32_t maxRefinements, double factor)
+{
+  if (factor <= 1.0) throw std::invalid_argument("Refinement factor must be larger than 1...");
+  m_maxRefinements = maxRefinements;
+  m_refinementFactor = factor;
+}
+
+bool QUBOSolver::isPenaltyViolated(fuint32_t group)
+{
+  if (m_values.empty()) throw std::runtime_error("Solution is nullptr...");
+  if (group >= m_groups.size()) throw std::range_error("Penalty group index out of range...");
+  return evaluatePenalty(m_groups[group]) > 0.5;
+}
+
+double QUBOSolver::evaluatePenalty(const PenaltyGroup& group)
+{
+  double value = group.constant;
+  for (const auto& term : group.terms)
+  {
+    if (getValue(term.x) && getValue(term.y)) value += term.coefficient;
+  }
+  return value;
+}
+
+bool QUBOSolver::refinePenalties()
+{
+  bool refined = false;
+  for (auto& group : m_groups)
+  {
+    if (evaluatePenalty(group) <= 0.5) continue;
+    group.penalty *= m_refinementFactor;
+    refined = true;
+  }
+  return refined;
+}
+
 
 std::ostream& operator<<(std::ostream& os, const QUBOSolver& solver)
 {
+  std::map<VariablePair, double> coefficients{};
+  for (const auto& term : solver.getEffectiveCoefficients())
+  {
+    coefficients.insert(std::make_pair(VariablePair(term.x, term.y), term.coefficient));
+  }
   os << "----------------------------------------" << std::endl;
   os << solver.m_variables.size() << " binary variables defined." << std::endl;
-  os << solver.m_coefficients.size() << " used cells in the matrix. " << std::endl;
+  os << coefficients.size() << " used cells in the matrix. " << std::endl;
   os << "Matrix Q:" << std::endl;
   for (fuint32_t i = 0; i < solver.m_variables.size(); i++)
   {
     for (fuint32_t j = 0; j < solver.m_variables.size(); j++)
     {
-      const auto it = solver.m_coefficients.find(std::make_pair(i, j));
-      if (it == solver.m_coefficients.end())
+      const auto it = coefficients.find(std::make_pair(i, j));
+      if (it == coefficients.end())
       {
         os << "0 ";
       }
@@ -384,5 +2000,6 @@ std::ostream& operator<<(std::ostream& os, const QUBOSolver& solver)
     os << std::endl;
   }
   os << "----------------------------------------" << std::endl;
+  return os;
 }
 }
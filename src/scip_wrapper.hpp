@@ -4,26 +4,32 @@
 // keksklauer4 16.03.2021
 
 #include <cinttypes>
+#include <cmath>
 #include <vector>
 #include <cstring>
 #include <string>
 #include <iostream>
 #include <exception>
+#include <stdexcept>
 #include <limits>
 #include <map>
+#include <set>
+#include <array>
+#include <algorithm>
+#include <initializer_list>
+#include <functional>
+#include <memory>
 
 // SCIP stuff
 #include <scip/scip.h>
 #include <scip/scipdefplugins.h>
 
 #include "../external/scip_exception.hpp"
+#include "scip_types.hpp"
 
 
-// #define RELAX_PROBLEM // allows testing a relaxation
-
 namespace scip_wrapper
 {
-  typedef uint_fast32_t fuint32_t;
   typedef SCIP_SOL SCIPSolution;
   typedef SCIP SCIPModel;
   typedef std::pair<fuint32_t, fuint32_t> VariablePair;
@@ -31,18 +37,37 @@ namespace scip_wrapper
   const double EPSILON = std::numeric_limits<double>::min(); // minimal positive double value
   const double NEG_EPSILON = -EPSILON; // maximal negative double value
 
-  enum SolverSense
-  {
-    MINIMIZE = +1,
-    MAXIMIZE = -1
+  enum BranchDirection
+  { // child node SCIP prefers to visit first when branching on a variable
+    BRANCH_DOWN,
+    BRANCH_UP,
+    BRANCH_AUTO
   };
 
-  enum VariableType
-  {
-    BINARY,
-    INTEGER,
-    IMPLICIT_INTEGER,
-    CONTINUOUS
+  enum ResultStatus
+  { // what the last solve proved, independent of the way it was solved (SCIP, fast paths, cache)
+    RESULT_OPTIMAL,
+    RESULT_FEASIBLE,   // a limit was hit, the solution is the best one found
+    RESULT_INFEASIBLE,
+    RESULT_UNKNOWN     // neither a solution nor a proof of infeasibility (also before the first solve)
+  };
+
+  enum OrbitopeType
+  { // restriction on the rows of an orbitope matrix
+    FULL_ORBITOPE,
+    PARTITIONING_ORBITOPE, // exactly one 1 per row
+    PACKING_ORBITOPE       // at most one 1 per row
+  };
+
+  enum RowKind
+  { // constraint handler a row is committed to
+    LINEAR_ROW,
+    SETPPC_ROW,
+    LOGICOR_ROW,
+    KNAPSACK_ROW,
+    VARBOUND_ROW,
+    LAZY_ROW, // kept in the lazy row pool
+    NB_ROW_KINDS
   };
 
 
@@ -75,6 +100,163 @@ namespace scip_wrapper
   typedef SCIPConstraint<false> SCIPLinearConstraint;
   typedef SCIPConstraint<true> SCIPQuadraticConstraint;
 
+  template<typename T>
+  struct Span
+  { // non-owning view on contiguous indices/coefficients (e.g. a std::vector)
+    Span(const T *_first, std::size_t _count)
+      : first(_first), count(_count) {}
+    Span(const std::vector<T> &vec)
+      : first(vec.data()), count(vec.size()) {}
+    Span(std::initializer_list<T> list)
+      : first(list.begin()), count(list.size()) {}
+
+    const T *begin() const { return first; }
+    const T *end() const { return first + count; }
+    std::size_t size() const { return count; }
+    const T &operator[](std::size_t i) const { return first[i]; }
+
+    public:
+      const T *first;
+      std::size_t count;
+  };
+
+  typedef Span<fuint32_t> VariableSpan;
+  typedef Span<double> CoefficientSpan;
+
+  struct LinearRow
+  { // lhs <= sum coefficients[i] * x_vars[i] <= rhs, variables given by their indices
+    LinearRow(double _lhs, double _rhs)
+      : lhs(_lhs), rhs(_rhs) {}
+    void addVariable(fuint32_t varIndex, double coefficient = 1.0)
+    {
+      vars.push_back(varIndex);
+      coefficients.push_back(coefficient);
+    }
+
+    public:
+      std::vector<fuint32_t> vars;
+      std::vector<double> coefficients;
+      double lhs;
+      double rhs;
+  };
+
+  typedef Span<double> SolutionView; // dense solution values indexed by the wrapper's variable indices
+  typedef std::function<std::vector<LinearRow>(SolutionView)> RowCallback; // returns rows violated by the solution
+  typedef RowCallback LazyConstraintCallback;
+  typedef RowCallback SeparatorCallback;
+  const fuint32_t NO_VARIABLE = std::numeric_limits<fuint32_t>::max();
+  // gets the LP solution and the fractional branching candidates, returns the variable to branch on (or NO_VARIABLE)
+  typedef std::function<fuint32_t(SolutionView, VariableSpan)> BranchingCallback;
+  struct PricedColumn
+  { // a new variable, rows are positions in the rows passed to addPricer
+    PricedColumn(fuint32_t _tag, double _objective, double _upperBound = 1.0, bool _integral = true)
+      : tag(_tag), objective(_objective), upperBound(_upperBound), integral(_integral) {}
+    void addCoefficient(fuint32_t row, double coefficient = 1.0)
+    {
+      rows.push_back(row);
+      coefficients.push_back(coefficient);
+    }
+
+    public:
+      fuint32_t tag; // identifies the column, columns with a known tag are not added again
+      double objective;
+      double upperBound;
+      bool integral;
+      std::vector<fuint32_t> rows;
+      std::vector<double> coefficients;
+  };
+  typedef std::vector<PricedColumn> PricedColumnVec;
+  // gets the duals of the priced rows and returns new columns: improving columns have objective - sum duals * coefficients
+  // < 0 when minimizing (> 0 when maximizing). With farkas == true the master LP is infeasible and columns with
+  // sum duals * coefficients > 0 restore feasibility.
+  typedef std::function<PricedColumnVec(CoefficientSpan duals, bool farkas)> PricingCallback;
+  typedef std::vector<double> Assignment; // dense values indexed by the wrapper's variable indices
+  typedef std::function<std::vector<Assignment>(SolutionView)> HeuristicCallback; // returns candidate solutions
+
+  struct LPSolution
+  { // dense buffers, reused if the same LPSolution is passed again
+    LPSolution() : objective(0.0), nbIterations(0), infeasible(false) {}
+
+    public:
+      double objective;
+      std::vector<double> values; // indexed by the variable indices
+      std::vector<double> reducedCosts; // indexed by the variable indices
+      std::vector<double> duals; // indexed by the constraint indices
+      int nbIterations;
+      bool infeasible; // proven by the LP solver, the buffers are not filled then
+  };
+
+  struct ModelKey
+  { // 128 bit content hash of a model (see ModelHash)
+    ModelKey() : high(0), low(0) {}
+    bool operator<(const ModelKey &other) const { return high != other.high ? high < other.high : low < other.low; }
+    bool operator==(const ModelKey &other) const { return high == other.high && low == other.low; }
+    std::string toString() const; // 32 hex digits
+
+    public:
+      uint64_t high;
+      uint64_t low;
+  };
+
+  struct ModelHash
+  { // updated while the model is built: columns and row sides in index order, nonzeros in any order
+    ModelHash() : columns{}, rows{}, nonzeros{}, nbColumns(0), nbRows(0), nbNonzeros(0) {}
+    void addColumn(VariableType type, double lowerBound, double upperBound, double objective);
+    void addRow(double lhs, double rhs);
+    void addNonzero(fuint32_t row, fuint32_t var, double coefficient);
+    void addNonzeros(const ModelHash &other); // nonzeros hashed elsewhere (e.g. by another thread)
+    ModelKey getKey(SCIP *scip) const; // also covers the objective sense and the tolerances of scip
+
+    public:
+      std::array<uint64_t, 2> columns;
+      std::array<uint64_t, 2> rows;
+      std::array<uint64_t, 2> nonzeros; // sums, thus independent of the order of addToCst calls
+      uint64_t nbColumns;
+      uint64_t nbRows;
+      uint64_t nbNonzeros;
+  };
+
+  struct SolverConfig
+  { // parameter set of a member of a portfolio (see MILPSolver::solvePortfolio)
+    SolverConfig(const std::string &_name, SCIP_PARAMEMPHASIS _emphasis = SCIP_PARAMEMPHASIS_DEFAULT,
+                 SCIP_PARAMSETTING _presolving = SCIP_PARAMSETTING_DEFAULT,
+                 SCIP_PARAMSETTING _heuristics = SCIP_PARAMSETTING_DEFAULT, int _seedShift = 0)
+      : name(_name), emphasis(_emphasis), presolving(_presolving), heuristics(_heuristics), seedShift(_seedShift) {}
+    void setParameter(const std::string &parameter, double value) { parameters.push_back(std::make_pair(parameter, value)); }
+
+    public:
+      std::string name;
+      SCIP_PARAMEMPHASIS emphasis;
+      SCIP_PARAMSETTING presolving;
+      SCIP_PARAMSETTING heuristics;
+      int seedShift; // randomization/randomseedshift
+      std::vector<std::pair<std::string, double>> parameters; // bool, int or real SCIP parameters set last
+  };
+  // emphasis and presolving/heuristics settings first, then the default settings with different seeds
+  std::vector<SolverConfig> createDefaultPortfolio(fuint32_t nbConfigs);
+
+  struct PortfolioStatistics
+  { // wins per config name, may be shared by the solves of many instances
+    PortfolioStatistics() : nbRaces(0) {}
+    fuint32_t getWins(const std::string &name) const;
+    std::vector<SolverConfig> prune(const std::vector<SolverConfig> &configs, fuint32_t nbKept) const; // most wins first
+    void print(std::ostream &os) const;
+
+    public:
+      std::map<std::string, fuint32_t> wins;
+      fuint32_t nbRaces;
+  };
+
+  // see scip_plugins.hpp
+  struct LazyConstraintHandler;
+  struct LazyRowPool;
+  struct SeparatorHandler;
+  struct HeuristicHandler;
+  struct BranchingHandler;
+  struct PricerHandler;
+  class SolutionCache; // see scip_cache.hpp
+  class ModelBuilder; // see scip_builder.hpp
+
   class MILPSolver
   {
     public:
@@ -83,6 +265,27 @@ namespace scip_wrapper
 
     public:
       bool solve();
+      // LP relaxation of the linear rows and variable bounds (integrality and other constraints are dropped), solved by the
+      // LP solver directly. The model is not changed, thus solve() still solves the original problem afterwards.
+      bool solveRelaxation(LPSolution &solution);
+      // opt-in: pure LPs (only continuous variables and linear rows, no plugins) are solved by the LP solver directly,
+      // the duals and reduced costs of the last such solve are kept. Constraints added through the SCIP handle are not seen.
+      void setLPFastPath(bool enabled) { m_lpFastPath = enabled; }
+      const LPSolution &getLPSolution() const { return m_lpSolution; }
+      // opt-in: network flow models (equality rows, every column has one +1 and one -1 entry, see scip_network.hpp) are
+      // solved by the network simplex, also with integer variables if all data is integral. The flows are read by variable
+      // index. As for the LP fast path, constraints added through the SCIP handle are not seen.
+      void setNetworkFastPath(bool enabled) { m_networkFastPath = enabled; }
+      // opt-in: solve() looks the model up by its content hash and stores proven results (optimal solutions and
+      // infeasibility). Only models of variables and rows are cached, changes made through the SCIP handles are not seen.
+      void setCache(SolutionCache *cache) { m_cache = cache; }
+      ModelKey getModelKey() const { return m_modelHash.getKey(m_scip_model); }
+      // splits the problem into 2^k copies by fixing k binaries (chosen by branching priority if none are given),
+      // the copies are solved by nbThreads threads sharing the best objective value as cutoff
+      bool solveDecomposed(fuint32_t nbThreads, VariableSpan splitVars = VariableSpan{nullptr, 0});
+      // races copies with different parameter sets, the first copy proving optimality (or infeasibility) wins and the
+      // others are interrupted. The winner is counted in the statistics (if given).
+      bool solvePortfolio(const std::vector<SolverConfig> &configs, fuint32_t nbThreads, PortfolioStatistics *statistics = nullptr);
       void setNbVars(fuint32_t nb);
       void setNbCsts(fuint32_t nb);
 
@@ -98,31 +301,191 @@ namespace scip_wrapper
       fuint32_t createLinearConstraintEq(double equalVal = 0.0, const char* name = "");
       fuint32_t createLinearConstraintGeq(double lhs, const char *name = "");
       fuint32_t createLinearConstraintLeq(double rhs, const char *name = "");
-      void createUnequalConstraint(fuint32_t x1, fuint32_t x2, double largeNb);
+      fuint32_t createUnequalConstraint(fuint32_t x1, fuint32_t x2); // returns the binary deciding x1 > x2
+      void createIndicatorConstraint(fuint32_t binVar, bool activeValue, const LinearRow &row, const char *name = "");
+
+      // special ordered sets, the weights define the order (index order if no weights are given)
+      void createSOS1(VariableSpan vars, CoefficientSpan weights = CoefficientSpan{nullptr, 0}, const char *name = "");
+      void createSOS2(VariableSpan vars, CoefficientSpan weights = CoefficientSpan{nullptr, 0}, const char *name = "");
+      // at most k of vars are nonzero, indicatorVars (binary, optional) are 1 if the respective variable is nonzero
+      void createCardinalityConstraint(VariableSpan vars, fuint32_t k, VariableSpan indicatorVars = VariableSpan{nullptr, 0},
+                                       CoefficientSpan weights = CoefficientSpan{nullptr, 0}, const char *name = "");
+
+      // symmetry handling (disables SCIP's automatic symmetry detection to stay compatible), binary variables only:
+      // the columns of the matrix (given as rows of variables) are interchangeable and get sorted lexicographically
+      void createOrbitope(const std::vector<std::vector<fuint32_t>> &matrix, OrbitopeType type = FULL_ORBITOPE, const char *name = "");
+      // vars >=lex permuted vars, permutation[i] is the position vars[i] is mapped to
+      void createSymresack(VariableSpan vars, const std::vector<fuint32_t> &permutation, const char *name = "");
+      // greater >=lex smaller, also for integer variables with finite bounds (as a weighted linear row)
+      void createLexOrder(VariableSpan greater, VariableSpan smaller, const char *name = "");
+
+      // column generation: the given (not yet committed) rows stay modifiable and the callback adds columns to them,
+      // all improving columns should be returned (columns already known by their tag are skipped)
+      void addPricer(PricingCallback callback, const std::vector<fuint32_t> &rows, const std::string &name = "");
+      std::vector<std::pair<fuint32_t, double>> getPricedColumnValues(); // tags and values of nonzero priced columns
+      fuint32_t getNbPricedColumns() const;
+
+      // Benders decomposition (minimization only): the master keeps its variables, each subproblem (LP or MILP) gets copies
+      // of the master variables it depends on given as pairs (master index, subproblem index). SCIP adds optimality and
+      // feasibility cuts to the master. Subproblems are committed on the first solve() and must outlive the master.
+      void addBendersSubproblem(MILPSolver &subproblem, const std::vector<std::pair<fuint32_t, fuint32_t>> &linkingVars);
+      bool setBendersThreads(int threads); // subproblems are solved in parallel if SCIP supports it (returns false otherwise)
+      void printBendersStatistics(std::ostream &os) const;
+
+      // the callback returns rows violated by the given solution, these are added as cuts (or constraints)
+      void addLazyConstraintCallback(LazyConstraintCallback callback, bool separateFractional = true);
+      fuint32_t getNbLazyRowsAdded() const;
+      // a lazy row is kept in a row pool instead of the LP and only added as cut once it is violated
+      void setLazy(fuint32_t cstIndex);
+
+      // the callback gets the LP solution and returns cuts, only cuts violated by the LP solution are added
+      void addSeparator(SeparatorCallback callback, int priority = 0, int frequency = 1, const std::string &name = "");
+      void printSeparatorStatistics(std::ostream &os) const;
+
+      // the callback gets the LP (or pseudo) solution of the current node and returns complete assignments of all variables,
+      // which are tried as new incumbents (slack variables of indicator constraints are set automatically)
+      void addHeuristic(HeuristicCallback callback, SCIP_HEURTIMING timing = SCIP_HEURTIMING_AFTERNODE,
+                        int frequency = 1, const std::string &name = "");
+      void printHeuristicStatistics(std::ostream &os) const;
+
+      // variables with higher priority are branched on first, setDefaultBranching applies to variables created afterwards
+      void setBranching(fuint32_t varIndex, int priority, BranchDirection direction = BRANCH_AUTO);
+      void setBranching(VariableSpan vars, int priority, BranchDirection direction = BRANCH_AUTO);
+      void setDefaultBranching(int priority, BranchDirection direction = BRANCH_AUTO);
+      // the callback is asked before SCIP's branching rules, which are used if it returns NO_VARIABLE (or a variable
+      // that is no candidate)
+      void addBranchingRule(BranchingCallback callback, const std::string &name = "");
 
       void addToCst(fuint32_t cstIndex, fuint32_t varIndex, double coefficient = 1.0);
+      // creates the variables and stages the rows of all contexts of a builder in index order (in one bulk step, as SCIP is
+      // not thread-safe) and resets the builder for further use
+      void merge(ModelBuilder &builder);
+      fuint32_t getNbVars() const { return m_variables.size(); }
+      fuint32_t getNbCsts() const { return m_csts.size(); }
 
       double getVariableValue(fuint32_t variableIndex);
       bool getBinaryValue(fuint32_t VariableIndex);
       SCIPSolution *getSolution() { return m_solution; }
-      SCIPLinearConstraint *getCst(fuint32_t index) { return index < m_csts.size() ? &m_csts.at(index) : nullptr; }
+      ResultStatus getResultStatus() const { return m_resultStatus; }
+      SCIPLinearConstraint *getCst(fuint32_t index);
       SCIPVariable *getVar(fuint32_t index) { return index < m_variables.size() ? &m_variables.at(index) : nullptr; }
       SCIPModel *getModel() { return m_scip_model; }
       void setLogging() { SCIP_CALL_EXC(SCIPsetIntParam(m_scip_model, "display/verblevel", 5)); }
+      // SCIP settings files (e.g. written by the tuning tool)
+      void loadSettings(const std::string &path) { SCIP_CALL_EXC(SCIPreadParams(m_scip_model, path.c_str())); }
+      void writeSettings(const std::string &path) { SCIP_CALL_EXC(SCIPwriteParams(m_scip_model, path.c_str(), TRUE, TRUE)); }
+      // writes the original problem in any format SCIP writes (e.g. "mps", "lp" or "cip", taken from the file name if not
+      // given), a ".gz" suffix compresses the output
+      void write(const std::string &path, const std::string &format = "");
+      // replaces the model by the one in the file (anything SCIPreadProb reads, also gzipped). Variables and rows are
+      // indexed in the order of the file, rows are linear, setppc, logicor, knapsack and varbound constraints.
+      void read(const std::string &path);
+      // binary snapshot of the variables and staged rows (bounds, types, objective, sides, lazy flags and the rows as
+      // compressed sparse rows), written in one pass and loaded using mmap without any parsing. Loading replaces the model
+      // and checks the version and checksum of the file. Other constraints and plugins are not part of a snapshot.
+      void writeSnapshot(const std::string &path);
+      void readSnapshot(const std::string &path);
+      // an empty problem keeping the SCIP instance (plugins, parameters, objective sense), thus a solver can be reused for
+      // many models without paying for SCIPincludeDefaultPlugins again. Fails once plugins refer to the variables.
+      void clearModel();
+      SCIP_Longint getNbNodes() { return SCIPgetStage(m_scip_model) >= SCIP_STAGE_TRANSFORMED ? SCIPgetNNodes(m_scip_model) : 0; }
+      double getSolvingTime() { return SCIPgetSolvingTime(m_scip_model); }
+
+      // rows are staged and committed to SCIP on solve(), if possible as specialized constraint
+      void setRowUpgrade(bool upgrade) { m_upgradeRows = upgrade; }
+      void commitRows();
+      fuint32_t getNbRows(RowKind kind) const { return m_rowStatistics[kind]; }
+      fuint32_t getNbUpgradedRows() const { return m_nbCommittedRows - m_rowStatistics[LINEAR_ROW] - m_rowStatistics[LAZY_ROW]; }
+      void printRowStatistics(std::ostream &os) const;
+
+    private:
+      void resetTransform();
+      void writeOrigProblem(const std::string &path, const std::string &format);
+      void releaseModel();
+      void disableAutomaticSymmetry();
+      void createBenders();
+      void nameBendersVars(const std::string &prefix);
+      void storeSolution(const std::vector<double> &values);
+      bool isPureLP() const;
+      bool hasOnlyLinearRows() const;
+      bool solveNetwork();
+      bool solveModel();
+      void rehashModel();
+      void freeSolution();
+      RowKind commitRow(fuint32_t index);
+      bool upgradeRow(const LinearRow &row, const char *name, SCIP_CONS **cons, RowKind &kind);
+      std::vector<SCIP_VAR*> collectVars(VariableSpan vars);
+      void collectRow(const LinearRow &row, std::vector<SCIP_VAR*> &vars, std::vector<double> &coefficients, double sign);
 
     private:
       SCIPModel *m_scip_model;
       SCIPSolution *m_solution;
+      bool m_ownsSolution; // solutions of copies and the LP solver are created by the wrapper
       std::vector<SCIPVariable> m_variables;
       std::vector<SCIPLinearConstraint> m_csts;
+      std::vector<LinearRow> m_rows; // staged rows, kept after commit as the wrapper's copy of the matrix
+      std::map<fuint32_t, std::string> m_rowNames;
+      fuint32_t m_nbCommittedRows;
+      bool m_upgradeRows;
+      std::array<fuint32_t, NB_ROW_KINDS> m_rowStatistics;
+      std::vector<SCIP_CONS*> m_specialCsts; // constraints of other handlers than cons_linear
+      std::vector<std::unique_ptr<LazyConstraintHandler>> m_lazyHandlers;
+      std::unique_ptr<LazyRowPool> m_lazyRowPool;
+      std::set<fuint32_t> m_lazyRows;
+      std::vector<std::unique_ptr<SeparatorHandler>> m_separators;
+      std::vector<std::unique_ptr<HeuristicHandler>> m_heuristics;
+      std::vector<std::unique_ptr<BranchingHandler>> m_branchingRules;
+      std::vector<std::unique_ptr<PricerHandler>> m_pricers;
+      std::set<fuint32_t> m_pricedRows;
+      std::vector<MILPSolver*> m_bendersSubproblems;
+      std::set<fuint32_t> m_bendersLinkVars; // named after the linked master variable
+      int m_defaultBranchPriority;
+      BranchDirection m_defaultBranchDirection;
+      bool m_bendersCreated;
+      bool m_lpFastPath;
+      bool m_networkFastPath;
+      SolutionCache *m_cache;
+      ResultStatus m_resultStatus;
+      LPSolution m_lpSolution;
+      ModelHash m_modelHash;
       std::string m_name;
   };
 
 
+  const double AUTO_PENALTY = 0.0; // let the QUBOSolver calibrate the penalties itself
+
+
+  struct QUBOTerm
+  { // x <= y, linear terms have x == y
+    QUBOTerm(fuint32_t _x, fuint32_t _y, double _coefficient)
+      : x(_x), y(_y), coefficient(_coefficient) {}
+    bool operator<(const QUBOTerm &other) const { return x < other.x || (x == other.x && y < other.y); }
+    bool operator==(const QUBOTerm &other) const { return x == other.x && y == other.y && coefficient == other.coefficient; }
+
+    public:
+      fuint32_t x;
+      fuint32_t y;
+      double coefficient;
+  };
+
+  typedef std::vector<QUBOTerm> QUBOTermVec;
+
+  struct PenaltyGroup
+  { // penalty terms are stored unscaled so that the penalty can be changed without rebuilding
+    PenaltyGroup(double _penalty)
+      : penalty(_penalty), constant(0.0), explicitPenalty(false) {}
+
+    public:
+      QUBOTermVec terms;
+      double penalty;
+      double constant; // constant part of the penalty expression (only needed to detect violations)
+      bool explicitPenalty; // set by setPenalty, not changed by the calibration
+  };
+
   class QUBOSolver
   {
     public:
-      QUBOSolver(SolverSense sense, double penalty);
+      QUBOSolver(SolverSense sense, double penalty = AUTO_PENALTY);
       ~QUBOSolver();
       friend std::ostream& operator<<(std::ostream& os, const QUBOSolver& solver);
 
@@ -132,6 +495,7 @@ namespace scip_wrapper
       bool getBinaryValue(fuint32_t x);
       void addQuadraticTerm(fuint32_t x, fuint32_t y, double coefficient = 1.0, bool withPenalty = false);
       void addLinearTerm(fuint32_t x, double coefficient = 1.0, bool withPenalty = false);
+      void addConstantTerm(double constant, bool withPenalty = true);
 
       void addImplicationTerm(fuint32_t x, fuint32_t y);
       void addEqualityTerm(fuint32_t x, fuint32_t y);
@@ -141,20 +505,58 @@ namespace scip_wrapper
       void addLeqTerm(fuint32_t x, fuint32_t y);
       void addGeqTerm(fuint32_t x, fuint32_t y);
 
+      // k-ary constraints, the squared penalty is expanded in one pass
+      void addOneHot(VariableSpan vars);
+      void addCardinality(VariableSpan vars, fuint32_t k);
+      void addAtMostK(VariableSpan vars, fuint32_t k);
+      void addLinearEquality(VariableSpan vars, CoefficientSpan coefficients, double rhs);
+
+      // penalty terms are collected in groups, each group has its own penalty factor
+      fuint32_t addPenaltyGroup();
+      void setPenaltyGroup(fuint32_t group);
+      fuint32_t getNbPenaltyGroups() const { return m_groups.size(); }
+      double getPenalty(fuint32_t group) const;
+      void setPenalty(fuint32_t group, double penalty);
+      void calibratePenalties();
+      void setAdaptivePenalty(fuint32_t maxRefinements, double factor = 2.0);
+      bool isPenaltyViolated(fuint32_t group);
+
+      // an empty problem keeping the SCIP instance (plugins and parameters) for the next model
+      void clearModel(SolverSense sense, double penalty = AUTO_PENALTY);
+      SCIPModel *getModel() { return m_scip_model; }
+
     private:
-      void fillTargetConstraint();
+      void createProblem();
+      void releaseModel();
+      void createTargetConstraint();
+      void fillTargetConstraint(const QUBOTermVec &coefficients);
+      void resetTransform();
+      void addWarmStart();
+      void solveModel();
+      bool getValue(fuint32_t x) const { return x < m_values.size() && m_values[x]; }
+      bool refinePenalties();
+      double evaluatePenalty(const PenaltyGroup& group);
+      void addSquaredPenalty(VariableSpan vars, const double *coefficients, double rhs);
+      QUBOTermVec getEffectiveCoefficients() const;
 
     private:
       SCIPModel *m_scip_model;
       SCIPSolution *m_solution;
       std::vector<SCIPVariable> m_variables;
-      std::map<VariablePair, double> m_coefficients;
+      QUBOTermVec m_coefficients;
+      QUBOTermVec m_pushedCoefficients; // terms currently contained in m_targetConstraint
+      std::vector<PenaltyGroup> m_groups;
+      std::vector<bool> m_values;
 
       SCIPVariable m_targetVar;
       SCIPQuadraticConstraint m_targetConstraint;
 
       SolverSense m_sense;
       double m_penalty;
+      bool m_autoPenalty;
+      fuint32_t m_currentGroup;
+      fuint32_t m_maxRefinements;
+      double m_refinementFactor;
   };
 }
 